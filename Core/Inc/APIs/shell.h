@@ -16,6 +16,7 @@
 #include <stddef.h>
 #include "main.h"
 #include "uart_driver.h"
+#include "shell_transport.h"
 
 #define TAB_SEQ       "\t"        /**< Tab character for terminal output */
 #define NEWLINE_SEQ   "\r\n"      /**< Newline sequence for terminal output */
@@ -37,6 +38,40 @@
 #define SHELL_HISTORY_SIZE 10
 #endif
 
+/**
+ * @def SHELL_RX_CHUNK_SIZE
+ * @brief Number of bytes drained from the transport per bulk read in shell_task().
+ */
+#ifndef SHELL_RX_CHUNK_SIZE
+#define SHELL_RX_CHUNK_SIZE 32
+#endif
+
+/**
+ * @def SHELL_TX_TIMEOUT_MS
+ * @brief How long shell output waits for transport room before bytes are dropped.
+ */
+#ifndef SHELL_TX_TIMEOUT_MS
+#define SHELL_TX_TIMEOUT_MS 100U
+#endif
+
+/**
+ * @def SHELL_BAUD_CONFIRM_MS
+ * @brief How long a trial baud rate change waits for 'baud ok' before reverting.
+ */
+#ifndef SHELL_BAUD_CONFIRM_MS
+#define SHELL_BAUD_CONFIRM_MS 10000U
+#endif
+
+/**
+ * @def SHELL_TX_WRITE_COMBINING
+ * @brief When 1, the shell's UART driver runs in write-combining mode
+ * (uart_driver_set_tx_deferred()) and shell_task() starts the transmitter
+ * once per pass, so the echo and redraw writes of a key leave in one burst.
+ */
+#ifndef SHELL_TX_WRITE_COMBINING
+#define SHELL_TX_WRITE_COMBINING 1
+#endif
+
 /**
  * @struct shell_history_t
  * @brief Command history buffer and navigation state.
@@ -50,38 +85,74 @@ typedef struct {
     int browse_index;     /**< Index for browsing history */
 } shell_history_t;
 
+/**
+ * @enum shell_parse_state_t
+ * @brief Escape-sequence parsing state of the input stream.
+ */
+typedef enum {
+    SHELL_PARSE_NORMAL,   /**< Plain input */
+    SHELL_PARSE_ESC,      /**< ESC received */
+    SHELL_PARSE_CSI       /**< ESC [ received */
+} shell_parse_state_t;
+
 /**
  * @struct rx_command_t
  * @brief Input line buffer and cursor state.
  *
- * Stores the current input line and cursor position.
+ * Stores the current input line, cursor position and escape-sequence state.
  */
 typedef struct rx_command_ {
     uint8_t buffer[SHELL_MAX_LENGTH]; /**< Input line buffer */
     size_t length;                    /**< Current length of input */
     size_t cursor_pos;                /**< Cursor position in buffer */
+    shell_parse_state_t parse_state;  /**< Escape-sequence parsing state */
 } rx_command_t;
 
+/**
+ * @struct shell_baud_t
+ * @brief Trial baud rate change waiting for confirmation.
+ */
+typedef struct {
+    uint32_t revert_rate;   /**< Rate to go back to, 0 if nothing is pending */
+    uint32_t start_tick;    /**< HAL tick the change was made at */
+} shell_baud_t;
+
 /**
  * @struct shell_t
  * @brief Shell instance structure.
  *
- * Contains all state for a shell session, including UART driver,
- * input buffer, and command history.
+ * Contains all state for a shell session, including the transport,
+ * input buffer, and command history. The shell only talks to the
+ * transport; driver backs it when the shell runs on its UART.
  */
 typedef struct shell_ {
-    uart_driver_t driver;    /**< UART driver instance */
+    shell_transport_t transport; /**< Byte transport for all input and output */
+    uart_driver_t driver;    /**< UART driver instance, the transport unless shell_init_transport() was used */
     shell_history_t history; /**< Command history state */
     rx_command_t rx;         /**< Input line state */
+    shell_baud_t baud;       /**< Pending trial baud rate change */
 } shell_t;
 
+/**
+ * @def SHELL_INITIALIZER
+ * @brief Constant initializer for a statically allocated shell.
+ *
+ * Wires the UART driver at compile time (see UART_DRIVER_INITIALIZER());
+ * history and line state start zeroed. Start it with shell_start() instead
+ * of shell_init().
+ */
+#define SHELL_INITIALIZER(self, handle) {                                                   \
+    .transport = SHELL_TRANSPORT_UART_INITIALIZER(&(self).driver),                          \
+    .driver = UART_DRIVER_INITIALIZER((self).driver, (handle)),                             \
+}
+
 /**
  * @brief Get the UART driver instance from a shell.
  * @param shell Pointer to the shell instance.
- * @return Pointer to the uart_driver_t instance.
+ * @return Pointer to the uart_driver_t instance, NULL if the shell runs on another transport.
  */
 static inline uart_driver_t *shell_get_driver_instance(shell_t *shell) {
-    return &shell->driver;
+    return (shell->transport.context == &shell->driver) ? &shell->driver : NULL;
 }
 
 /**
@@ -92,14 +163,40 @@ static inline uart_driver_t *shell_get_driver_instance(shell_t *shell) {
  */
 bool shell_init(shell_t *shell, UART_HandleTypeDef *huart);
 
+/**
+ * @brief Initializes the shell instance on another transport.
+ *
+ * The UART specific commands (baud, isrprof, uartstat) then report that
+ * there is no UART.
+ * @param shell Pointer to the shell instance to initialize.
+ * @param transport Transport to use, copied into the shell.
+ * @return true if initialization was successful, false otherwise.
+ */
+bool shell_init_transport(shell_t *shell, const shell_transport_t *transport);
+
+/**
+ * @brief Starts a shell instance defined with SHELL_INITIALIZER().
+ *
+ * Starts UART reception and prints the banner and prompt; the UART
+ * peripheral must already be initialized.
+ * @param shell Pointer to the shell instance.
+ * @return true if the shell was started, false otherwise.
+ */
+bool shell_start(shell_t *shell);
+
 /**
  * @brief Formatted print function for the shell.
- * Sends formatted output to UART.
+ * Sends formatted output to the transport, waiting up to SHELL_TX_TIMEOUT_MS
+ * for room. Callable from ISRs when UART_DRIVER_TX_MULTI_PRODUCER is
+ * enabled; it then queues what fits without waiting. With
+ * SHELL_TX_WRITE_COMBINING, output printed outside shell_task() leaves at
+ * the next shell_task() or shell_flush().
  * @param shell Pointer to the shell instance.
  * @param format Printf-style format string.
  * @param ... Variable arguments.
+ * @return Number of bytes queued, less than the formatted length if output was lost.
  */
-void shell_printf(shell_t *shell, const char *format, ...);
+size_t shell_printf(shell_t *shell, const char *format, ...);
 
 /**
  * @brief Clears the terminal screen using ANSI escape codes.
@@ -119,7 +216,8 @@ void shell_clear_screen(shell_t *shell);
 void shell_print_history(shell_t *shell);
 
 /**
- * @brief Sends raw bytes through the shell's UART interface.
+ * @brief Sends raw bytes through the shell's transport, waiting up to
+ * SHELL_TX_TIMEOUT_MS for room.
  * @param shell Pointer to the shell instance.
  * @param data Pointer to the data to send.
  * @param len Number of bytes to send.
@@ -127,10 +225,56 @@ void shell_print_history(shell_t *shell);
  */
 size_t shell_send_bytes(shell_t *shell, uint8_t *data, size_t len);
 
+/**
+ * @brief Sends bytes that stay valid and unchanged until they have left,
+ * such as const text in flash.
+ *
+ * On the UART they are queued by reference (uart_driver_send_ref()) and
+ * streamed from where they are, taking no TX ring space. Where that is not
+ * possible (another transport, an interrupt, the reference queue full)
+ * they are copied like shell_send_bytes().
+ * @param shell Pointer to the shell instance.
+ * @param data Pointer to the data to send.
+ * @param len Number of bytes to send.
+ * @return Number of bytes queued.
+ */
+size_t shell_send_static(shell_t *shell, const uint8_t *data, size_t len);
+
+/**
+ * @brief Switches the shell UART to a new baud rate.
+ *
+ * Output already queued is sent at the old rate first. With confirm set,
+ * shell_task() goes back to the old rate unless shell_confirm_baud() is
+ * called within SHELL_BAUD_CONFIRM_MS.
+ * @param shell Pointer to the shell instance.
+ * @param baud_rate New baud rate, checked with uart_driver_check_baud().
+ * @param confirm true to revert unless confirmed.
+ * @return true if the UART was switched, false otherwise.
+ */
+bool shell_set_baud(shell_t *shell, uint32_t baud_rate, bool confirm);
+
+/**
+ * @brief Keeps a trial baud rate change made with shell_set_baud().
+ * @param shell Pointer to the shell instance.
+ * @return true if a change was pending, false otherwise.
+ */
+bool shell_confirm_baud(shell_t *shell);
+
+/**
+ * @brief Waits until queued shell output has left the transport.
+ * @param shell Pointer to the shell instance.
+ * @param timeout_ms How long to wait.
+ * @return true if all output has left, false on timeout.
+ */
+bool shell_flush(shell_t *shell, uint32_t timeout_ms);
+
 /**
  * @brief Main shell processing loop.
- * Reads UART input and processes shell logic.
+ * Reads transport input and processes shell logic.
  * Handles escape sequences for arrow keys, printable characters, and line editing.
+ * Whole lines that are already received are taken in one bulk read.
+ * Reverts a trial baud rate change that was not confirmed in time.
+ * Ends by starting the transmitter on everything written during the pass.
  * @param shell Pointer to the shell instance.
  */
 void shell_task(shell_t *shell);
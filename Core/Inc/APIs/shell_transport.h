@@ -0,0 +1,215 @@
+/**
+ * @file shell_transport.h
+ * @brief Byte transport the shell runs on.
+ *
+ * The shell only moves bytes through a shell_transport_t: a table of
+ * operations plus the context they act on. A UART driver is the default
+ * transport; the loopback transport below serves the shell from two ring
+ * buffers, so its logic can run and be measured without any hardware.
+ * Another link (a shared-memory mailbox, a USB CDC endpoint, host stdio)
+ * plugs in by filling in the same table.
+ *
+ * @author Santiago Rincon
+ * @date 2026
+ */
+
+#ifndef __SHELL_TRANSPORT_H__
+#define __SHELL_TRANSPORT_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "ring_buffer.h"
+
+/**
+ * @brief Operations of a transport.
+ *
+ * send, recv, flush and ready are required. find, tx_acquire and tx_commit
+ * are fast paths the shell uses when present and may be NULL, as may
+ * send_ref, for transports that can send from the caller's memory. tx_kick is
+ * for transports that hold output back to combine writes; NULL if every
+ * send goes out on its own.
+ */
+typedef struct shell_transport_ops_ {
+    /** Queue up to length bytes, waiting up to timeout_ms for room; returns bytes queued */
+    size_t (*send)(void *context, const uint8_t *data, size_t length, uint32_t timeout_ms);
+    /** Take up to length received bytes without waiting; returns bytes read */
+    size_t (*recv)(void *context, uint8_t *buffer, size_t length);
+    /** Wait up to timeout_ms until queued output has left; returns true if it has */
+    bool (*flush)(void *context, uint32_t timeout_ms);
+    /** Number of received bytes waiting to be read */
+    size_t (*ready)(void *context);
+    /** Find the first received byte equal to byte, position relative to the next read */
+    bool (*find)(void *context, uint8_t byte, size_t *position);
+    /** Contiguous writable output region, 0 if none */
+    size_t (*tx_acquire)(void *context, uint8_t **region);
+    /** Queue length bytes written to the region returned by tx_acquire */
+    bool (*tx_commit)(void *context, size_t length);
+    /** Start sending output held back so far */
+    void (*tx_kick)(void *context);
+    /** Queue bytes by reference, without copying; false if it cannot and the caller must copy */
+    bool (*send_ref)(void *context, const uint8_t *data, size_t length);
+
+} shell_transport_ops_t;
+
+/**
+ * @brief A transport instance: its operations and the context they act on.
+ */
+typedef struct shell_transport_ {
+    const shell_transport_ops_t *ops;   /**< Operations, NULL if unbound */
+    void *context;                      /**< Passed to every operation */
+
+} shell_transport_t;
+
+/** Operations of the UART transport, context is a uart_driver_t */
+extern const shell_transport_ops_t shell_transport_uart_ops;
+
+/** Operations of the loopback transport, context is a shell_loopback_t */
+extern const shell_transport_ops_t shell_transport_loopback_ops;
+
+/**
+ * @def SHELL_TRANSPORT_UART_INITIALIZER
+ * @brief Constant initializer binding a transport to a UART driver.
+ */
+#define SHELL_TRANSPORT_UART_INITIALIZER(driver) { .ops = &shell_transport_uart_ops, .context = (driver) }
+
+/**
+ * @brief Loopback transport state.
+ *
+ * The shell reads its input from the input ring and writes its output to
+ * the output ring. The other side (a test or a benchmark) writes input with
+ * ring_buffer_write() and reads output with ring_buffer_read().
+ */
+typedef struct shell_loopback_ {
+    ring_buffer_t input;    /**< Bytes for the shell to receive */
+    ring_buffer_t output;   /**< Bytes the shell sent */
+
+} shell_loopback_t;
+
+/**
+ * @brief Initializes a loopback transport on caller-provided storage.
+ *
+ * @param loopback Pointer to loopback structure.
+ * @param input Input ring storage.
+ * @param input_size Size of input in bytes.
+ * @param output Output ring storage.
+ * @param output_size Size of output in bytes.
+ * @return true if initialization is successful, false otherwise.
+ */
+bool shell_loopback_init(shell_loopback_t *loopback, uint8_t *input, size_t input_size,
+                         uint8_t *output, size_t output_size);
+
+/**
+ * @brief Binds a transport to a loopback.
+ *
+ * @param transport Pointer to transport structure.
+ * @param loopback Loopback initialized with shell_loopback_init().
+ * @return true if bound, false if arguments are invalid.
+ */
+bool shell_transport_bind_loopback(shell_transport_t *transport, shell_loopback_t *loopback);
+
+/**
+ * @brief Sends bytes through a transport.
+ *
+ * @param transport Pointer to transport structure.
+ * @param data Bytes to send.
+ * @param length Number of bytes.
+ * @param timeout_ms How long to wait for room.
+ * @return Number of bytes queued.
+ */
+static inline size_t shell_transport_send(shell_transport_t *transport, const uint8_t *data, size_t length,
+                                          uint32_t timeout_ms) {
+    return transport->ops->send(transport->context, data, length, timeout_ms);
+}
+
+/**
+ * @brief Reads received bytes from a transport without waiting.
+ *
+ * @param transport Pointer to transport structure.
+ * @param buffer Destination.
+ * @param length Maximum number of bytes.
+ * @return Number of bytes read.
+ */
+static inline size_t shell_transport_recv(shell_transport_t *transport, uint8_t *buffer, size_t length) {
+    return transport->ops->recv(transport->context, buffer, length);
+}
+
+/**
+ * @brief Waits until output queued on a transport has left.
+ *
+ * @param transport Pointer to transport structure.
+ * @param timeout_ms How long to wait.
+ * @return true if all output has left, false on timeout.
+ */
+static inline bool shell_transport_flush(shell_transport_t *transport, uint32_t timeout_ms) {
+    return transport->ops->flush(transport->context, timeout_ms);
+}
+
+/**
+ * @brief Number of received bytes waiting on a transport.
+ *
+ * @param transport Pointer to transport structure.
+ * @return Byte count.
+ */
+static inline size_t shell_transport_ready(shell_transport_t *transport) {
+    return transport->ops->ready(transport->context);
+}
+
+/**
+ * @brief Finds a byte in the received data of a transport.
+ *
+ * @param transport Pointer to transport structure.
+ * @param byte Value to find.
+ * @param position Set to its offset from the next byte to read.
+ * @return true if found, false if not found or the transport cannot search.
+ */
+static inline bool shell_transport_find(shell_transport_t *transport, uint8_t byte, size_t *position) {
+    return (transport->ops->find != NULL) && transport->ops->find(transport->context, byte, position);
+}
+
+/**
+ * @brief Gets a contiguous output region to write in place.
+ *
+ * @param transport Pointer to transport structure.
+ * @param region Set to the region.
+ * @return Region size, 0 if none or the transport has no such region.
+ */
+static inline size_t shell_transport_tx_acquire(shell_transport_t *transport, uint8_t **region) {
+    return (transport->ops->tx_acquire != NULL) ? transport->ops->tx_acquire(transport->context, region) : 0U;
+}
+
+/**
+ * @brief Queues bytes written to a region from shell_transport_tx_acquire().
+ *
+ * @param transport Pointer to transport structure.
+ * @param length Number of bytes written.
+ * @return true if queued, false otherwise.
+ */
+static inline bool shell_transport_tx_commit(shell_transport_t *transport, size_t length) {
+    return (transport->ops->tx_commit != NULL) && transport->ops->tx_commit(transport->context, length);
+}
+
+/**
+ * @brief Queues bytes to send from the caller's memory.
+ *
+ * @param transport Pointer to transport structure.
+ * @param data Bytes to send, valid and unchanged until they have left.
+ * @param length Number of bytes.
+ * @return true if queued, false if not queued or the transport always copies.
+ */
+static inline bool shell_transport_send_ref(shell_transport_t *transport, const uint8_t *data, size_t length) {
+    return (transport->ops->send_ref != NULL) && transport->ops->send_ref(transport->context, data, length);
+}
+
+/**
+ * @brief Starts sending output a transport has held back.
+ *
+ * @param transport Pointer to transport structure.
+ */
+static inline void shell_transport_tx_kick(shell_transport_t *transport) {
+    if (transport->ops->tx_kick != NULL) {
+        transport->ops->tx_kick(transport->context);
+    }
+}
+
+#endif /* __SHELL_TRANSPORT_H__ */
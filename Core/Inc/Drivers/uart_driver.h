@@ -18,6 +18,8 @@
 #include <stdint.h>
 
 #include "ring_buffer.h"
+#include "element_ring.h"
+#include "flow_control.h"
 
 /**
  * @def UART_DRIVER_MAX_RX_BUFFER
@@ -31,7 +33,293 @@
  */
 #define UART_DRIVER_MAX_TX_BUFFER 256
 
+/**
+ * @def UART_DRIVER_RX_POLICY
+ * @brief Overflow policy of the RX ring buffer in IT mode.
+ *
+ * In DMA mode the stream overwrites unread bytes instead of waiting, so the
+ * RX ring always uses RING_BUFFER_POLICY_OVERWRITE_OLDEST.
+ */
+#ifndef UART_DRIVER_RX_POLICY
+#define UART_DRIVER_RX_POLICY RING_BUFFER_POLICY_DROP_NEWEST
+#endif
+
+/**
+ * @def UART_DRIVER_RX_DMA_GUARD
+ * @brief Bytes kept clear ahead of the DMA stream when reading in DMA RX mode.
+ *
+ * The stream keeps writing between events, over the oldest unread bytes if
+ * the application falls a buffer behind. Before each read the unread bytes
+ * within this distance of the stream are dropped, so it covers what the
+ * stream writes while the copy runs, interrupts included.
+ */
+#ifndef UART_DRIVER_RX_DMA_GUARD
+#define UART_DRIVER_RX_DMA_GUARD (16U)
+#endif
+
+/**
+ * @def UART_DRIVER_RX_HIGH_WATER
+ * @brief RX ring fill level at which RTS is deasserted when flow control is enabled.
+ *
+ * In DMA RX mode the level is only seen at half-transfer, transfer-complete
+ * and idle events, up to half the buffer late, so the default leaves half
+ * the buffer plus an eighth for the peer to stop above it.
+ */
+#ifndef UART_DRIVER_RX_HIGH_WATER
+#define UART_DRIVER_RX_HIGH_WATER ((UART_DRIVER_MAX_RX_BUFFER / 2U) - (UART_DRIVER_MAX_RX_BUFFER / 8U))
+#endif
 
+/**
+ * @def UART_DRIVER_RX_LOW_WATER
+ * @brief RX ring fill level at which RTS is asserted again.
+ */
+#ifndef UART_DRIVER_RX_LOW_WATER
+#define UART_DRIVER_RX_LOW_WATER (UART_DRIVER_MAX_RX_BUFFER / 8U)
+#endif
+
+/**
+ * @def UART_DRIVER_XON
+ * @brief Character asking the peer to resume sending (DC1, Ctrl-Q).
+ */
+#define UART_DRIVER_XON (0x11U)
+
+/**
+ * @def UART_DRIVER_XOFF
+ * @brief Character asking the peer to stop sending (DC3, Ctrl-S).
+ */
+#define UART_DRIVER_XOFF (0x13U)
+
+/**
+ * @def UART_DRIVER_XON_XOFF_DMA_CHUNK
+ * @brief Longest DMA TX transfer while XON/XOFF is enabled.
+ *
+ * A DMA transfer cannot be paused, so this bounds how much is still sent
+ * after the peer's XOFF, and how long our own XOFF waits behind it.
+ */
+#ifndef UART_DRIVER_XON_XOFF_DMA_CHUNK
+#define UART_DRIVER_XON_XOFF_DMA_CHUNK (16U)
+#endif
+
+/**
+ * @def UART_DRIVER_REGISTRY_SLOTS
+ * @brief Size of the USART instance to driver table.
+ *
+ * A USART's slot is taken from bits 10-14 of its base address. Each
+ * U(S)ART of the STM32F4 sits on its own 1 KB boundary and all eight land
+ * in distinct slots, so a lookup is a shift, a mask and a compare.
+ */
+#define UART_DRIVER_REGISTRY_SLOTS (32U)
+
+/**
+ * @def UART_DRIVER_BAUD_TOLERANCE
+ * @brief Largest accepted baud rate error, in tenths of a percent.
+ *
+ * The receiver tolerates about 3.75% (16x oversampling) or 3.3% (8x) of
+ * total mismatch, shared between both ends of the link.
+ */
+#ifndef UART_DRIVER_BAUD_TOLERANCE
+#define UART_DRIVER_BAUD_TOLERANCE (20U)
+#endif
+
+/**
+ * @def UART_DRIVER_TX_POLICY
+ * @brief Overflow policy of the TX ring buffer.
+ */
+#ifndef UART_DRIVER_TX_POLICY
+#define UART_DRIVER_TX_POLICY RING_BUFFER_POLICY_REJECT
+#endif
+
+/**
+ * @def UART_DRIVER_WAIT_FOREVER
+ * @brief Timeout for uart_driver_send_timeout()/uart_driver_flush() that never expires.
+ */
+#define UART_DRIVER_WAIT_FOREVER HAL_MAX_DELAY
+
+/**
+ * @brief Called repeatedly while a blocking call waits for the transmitter.
+ *
+ * E.g. a function executing __WFI(), or one running other main loop work.
+ *
+ * @param context Pointer given to uart_driver_set_idle_hook().
+ */
+typedef void (*uart_driver_idle_hook_t)(void *context);
+
+/**
+ * @brief Which interrupt handler moves the bytes.
+ */
+typedef enum {
+    UART_DRIVER_BACKEND_HAL = 0,    /**< HAL_UART_IRQHandler and the HAL callback chain, IT or DMA modes */
+    UART_DRIVER_BACKEND_REGISTER    /**< uart_driver_irq_handler: RXNE/TXE served straight from SR/DR */
+} uart_driver_backend_t;
+
+/**
+ * @def UART_DRIVER_BACKEND
+ * @brief Backend a driver starts with. The register backend always moves
+ * one byte per interrupt, so the RX/TX DMA modes only apply to the HAL one.
+ */
+#ifndef UART_DRIVER_BACKEND
+#define UART_DRIVER_BACKEND UART_DRIVER_BACKEND_HAL
+#endif
+
+/**
+ * @def UART_DRIVER_PROFILE
+ * @brief When 1, the bytes moved by the UART and UART DMA interrupts are
+ * counted as well, for the cost per byte.
+ *
+ * The interrupt count, total and longest interrupt, timed with the DWT
+ * cycle counter, are always kept (see uart_driver_get_profile()).
+ */
+#ifndef UART_DRIVER_PROFILE
+#define UART_DRIVER_PROFILE 0
+#endif
+
+/**
+ * @brief Interrupt cost of the UART and UART DMA handlers.
+ */
+typedef struct {
+    uint32_t irqs;                  /**< Interrupts timed */
+    uint32_t bytes;                 /**< Bytes received or sent by them, with UART_DRIVER_PROFILE */
+    uint64_t cycles;                /**< Core cycles spent in them */
+    uint32_t max_cycles;            /**< Longest single interrupt */
+} uart_driver_profile_t;
+
+/**
+ * @brief Flow control counters.
+ */
+typedef struct {
+    uint32_t rx_throttled;          /**< Times the peer was stopped (RTS deasserted or XOFF sent) */
+    uint32_t tx_paused;             /**< Times the peer stopped us with XOFF */
+} uart_driver_flow_stats_t;
+
+/**
+ * @brief Receive and DMA error counters.
+ */
+typedef struct {
+    uint32_t overrun;               /**< Bytes lost because DR was not read in time (ORE) */
+    uint32_t framing;               /**< Missing stop bit (FE) */
+    uint32_t noise;                 /**< Noise detected on a received byte (NE) */
+    uint32_t parity;                /**< Parity mismatch (PE) */
+    uint32_t dma;                   /**< DMA transfer errors */
+    uint32_t rx_restarts;           /**< Times reception stopped by an error was re-armed */
+} uart_driver_errors_t;
+
+/**
+ * @brief Traffic and buffer usage since the counters were last reset.
+ */
+typedef struct {
+    uint32_t elapsed_ms;            /**< Time the counters cover */
+    uint32_t rx_bytes;              /**< Bytes received */
+    uint32_t tx_bytes;              /**< Bytes sent */
+    size_t rx_dropped;              /**< Received bytes lost to a full RX ring, or overwritten or discarded in DMA mode */
+    size_t tx_dropped;              /**< Bytes that did not fit in the TX ring */
+    size_t rx_high_water;           /**< Highest RX ring fill level */
+    size_t tx_high_water;           /**< Highest TX ring fill level */
+    uint32_t tx_busy_ms;            /**< Time the transmitter had data to send */
+    uint32_t tx_transfers;          /**< Transfers started: DMA bursts, IT bytes or register backend runs */
+} uart_driver_stats_t;
+
+/**
+ * @brief How the driver collects received bytes.
+ */
+typedef enum {
+    UART_DRIVER_RX_MODE_IT = 0,     /**< One HAL interrupt reception per byte */
+    UART_DRIVER_RX_MODE_DMA         /**< Circular DMA into the RX ring, published on half/full transfer and line idle */
+} uart_driver_rx_mode_t;
+
+/**
+ * @def UART_DRIVER_RX_MODE
+ * @brief RX mode a driver starts in. DMA falls back to IT if the UART handle
+ * has no RX DMA stream linked.
+ */
+#ifndef UART_DRIVER_RX_MODE
+#define UART_DRIVER_RX_MODE UART_DRIVER_RX_MODE_DMA
+#endif
+
+/**
+ * @brief How the driver feeds the transmitter.
+ */
+typedef enum {
+    UART_DRIVER_TX_MODE_IT = 0,     /**< One HAL interrupt transfer per byte */
+    UART_DRIVER_TX_MODE_DMA         /**< One DMA transfer per contiguous TX ring region */
+} uart_driver_tx_mode_t;
+
+/**
+ * @def UART_DRIVER_TX_MODE
+ * @brief TX mode a driver starts in. DMA falls back to IT if the UART handle
+ * has no TX DMA stream linked.
+ */
+#ifndef UART_DRIVER_TX_MODE
+#define UART_DRIVER_TX_MODE UART_DRIVER_TX_MODE_DMA
+#endif
+
+/**
+ * @def UART_DRIVER_TX_MULTI_PRODUCER
+ * @brief When 1, uart_driver_send() may be called from ISRs at any priority
+ * and from the main loop at the same time.
+ *
+ * The TX ring then runs in multi-producer mode, and uart_driver_tx_acquire()
+ * always reports no region, so shell_printf() formats on the stack and
+ * copies instead of formatting in place. Off by default, as the firmware
+ * only prints from the main loop; enable it in builds that print from ISRs.
+ */
+#ifndef UART_DRIVER_TX_MULTI_PRODUCER
+#define UART_DRIVER_TX_MULTI_PRODUCER 0
+#endif
+
+/**
+ * @def UART_DRIVER_TX_DEFERRED
+ * @brief When 1, drivers start in write-combining mode (see uart_driver_set_tx_deferred()).
+ */
+#ifndef UART_DRIVER_TX_DEFERRED
+#define UART_DRIVER_TX_DEFERRED 0
+#endif
+
+/**
+ * @def UART_DRIVER_TX_KICK_THRESHOLD
+ * @brief TX ring fill level at which a deferred send starts the transmitter anyway.
+ *
+ * Keeps the line busy during long output instead of letting the ring fill
+ * up before the first byte goes out.
+ */
+#ifndef UART_DRIVER_TX_KICK_THRESHOLD
+#define UART_DRIVER_TX_KICK_THRESHOLD (UART_DRIVER_MAX_TX_BUFFER / 2U)
+#endif
+
+/**
+ * @def UART_DRIVER_TX_REF_QUEUE
+ * @brief Blocks uart_driver_send_ref() can have queued at once.
+ */
+#ifndef UART_DRIVER_TX_REF_QUEUE
+#define UART_DRIVER_TX_REF_QUEUE 8U
+#endif
+
+#if UART_DRIVER_TX_MULTI_PRODUCER
+#define UART_DRIVER_TX_RING_INITIALIZER(storage) RING_BUFFER_MP_INITIALIZER(storage, UART_DRIVER_TX_POLICY)
+#else
+#define UART_DRIVER_TX_RING_INITIALIZER(storage) RING_BUFFER_INITIALIZER(storage, UART_DRIVER_TX_POLICY)
+#endif
+
+_Static_assert(!UART_DRIVER_TX_MULTI_PRODUCER || (UART_DRIVER_TX_POLICY != RING_BUFFER_POLICY_OVERWRITE_OLDEST),
+               "the multi-producer TX ring cannot overwrite");
+
+RING_BUFFER_ASSERT_POW2(UART_DRIVER_MAX_RX_BUFFER);
+RING_BUFFER_ASSERT_POW2(UART_DRIVER_MAX_TX_BUFFER);
+_Static_assert(UART_DRIVER_MAX_RX_BUFFER <= UINT16_MAX, "the RX DMA stream takes a 16-bit length");
+_Static_assert((UART_DRIVER_TX_KICK_THRESHOLD > 0U) && (UART_DRIVER_TX_KICK_THRESHOLD <= UART_DRIVER_MAX_TX_BUFFER),
+               "invalid TX kick threshold");
+_Static_assert(UART_DRIVER_RX_DMA_GUARD < (UART_DRIVER_MAX_RX_BUFFER / 2U), "RX DMA guard must leave half the buffer");
+_Static_assert((UART_DRIVER_RX_LOW_WATER < UART_DRIVER_RX_HIGH_WATER) &&
+               (UART_DRIVER_RX_HIGH_WATER <= UART_DRIVER_MAX_RX_BUFFER), "invalid RX flow control watermarks");
+
+
+/**
+ * @brief A block queued by reference with uart_driver_send_ref().
+ */
+typedef struct {
+    const uint8_t *data;            /**< Next byte to send, in the caller's memory */
+    size_t length;                  /**< Bytes left to send */
+    size_t mark;                    /**< TX ring write index when queued: ring bytes before it go first */
+} uart_driver_tx_ref_t;
 
 /**
  * @brief UART driver context structure.
@@ -40,17 +328,118 @@
  */
 typedef struct uart_driver_ {
     UART_HandleTypeDef *huart;                      /**< Pointer to UART handle */
+    uart_driver_backend_t backend;                  /**< HAL or register-level interrupt handling */
 
-    ring_buffer_t ring_buffer_rx;                   /**< RX ring buffer */
-    ring_buffer_t ring_buffer_tx;                   /**< TX ring buffer */
+    ring_buffer_t ring_buffer_rx;                   /**< RX ring buffer (ISR produces, main loop consumes) */
+    ring_buffer_t ring_buffer_tx;                   /**< TX ring buffer (main loop and ISRs produce, TX ISR consumes) */
 
-    uint8_t tx_buffer[UART_DRIVER_MAX_TX_BUFFER];   /**< TX buffer memory */
-    uint8_t rx_buffer[UART_DRIVER_MAX_RX_BUFFER];   /**< RX buffer memory */
+    uint8_t tx_buffer[UART_DRIVER_MAX_TX_BUFFER] __attribute__((aligned(RING_BUFFER_STORAGE_ALIGN)));  /**< TX buffer memory */
+    uint8_t rx_buffer[UART_DRIVER_MAX_RX_BUFFER] __attribute__((aligned(RING_BUFFER_STORAGE_ALIGN)));  /**< RX buffer memory */
     volatile uint8_t rx_byte;                       /**< Last received byte */
+    uart_driver_rx_mode_t rx_mode;                  /**< Interrupt or circular DMA reception */
+    size_t rx_dma_position;                         /**< RX buffer offset the DMA stream was last published up to */
+    volatile bool rx_restart;                       /**< DMA reception ended by an error, re-armed by the next read */
+    uint8_t tx_byte;                                /**< Byte currently owned by the HAL transmitter */
     volatile bool tx_busy;                          /**< TX busy flag */
+    uint32_t tx_busy_since;                         /**< Cycle count tx_busy time was last accounted at */
+    uint64_t tx_busy_cycles;                        /**< Core cycles spent with tx_busy set */
+    uint32_t rx_count;                              /**< Bytes received */
+    uint32_t tx_count;                              /**< Bytes sent */
+    uint32_t tx_transfer_count;                     /**< Transfers started */
+    uint32_t stats_tick;                            /**< HAL tick the counters were last reset at */
+    uart_driver_tx_mode_t tx_mode;                  /**< Interrupt or DMA transmission */
+    size_t tx_dma_length;                           /**< TX ring bytes owned by the DMA transfer in flight */
+    bool tx_deferred;                               /**< Write-combining: sends only queue, uart_driver_tx_kick() starts */
+    element_ring_t tx_refs;                         /**< Blocks queued by reference after tx_ref */
+    uart_driver_tx_ref_t tx_ref_storage[UART_DRIVER_TX_REF_QUEUE]; /**< tx_refs memory */
+    uart_driver_tx_ref_t tx_ref;                    /**< Next block by reference, valid if tx_ref_valid */
+    bool tx_ref_valid;                              /**< tx_ref holds a block not fully sent */
+    size_t tx_ref_sending;                          /**< tx_ref bytes owned by the DMA transfer in flight */
+    size_t tx_ref_bytes;                            /**< Bytes queued by reference and not sent yet */
+    uart_driver_profile_t profile;                  /**< Interrupt cost */
+    bool flow_control;                              /**< RTS/CTS flow control enabled */
+    flow_control_t rx_flow;                         /**< RX ring watermark state driving RTS and XOFF */
+    GPIO_TypeDef *rts_port;                         /**< RTS output port, NULL if RTS is not wired */
+    uint16_t rts_pin;                               /**< RTS output pin, active low */
+    bool xon_xoff;                                  /**< XON/XOFF flow control enabled */
+    volatile uint8_t tx_flow_char;                  /**< XON/XOFF to send ahead of the TX ring, 0 if none */
+    volatile bool tx_paused;                        /**< Peer sent XOFF, TX ring drain paused */
+    uint32_t tx_pause_count;                        /**< Number of XOFFs received while running */
+    uart_driver_errors_t errors;                    /**< Receive and DMA error counters */
+    uart_driver_idle_hook_t idle_hook;              /**< Run while blocking calls wait, NULL to spin */
+    void *idle_context;                             /**< Argument passed to idle_hook */
 
 } uart_driver_t;
 
+/**
+ * @def UART_DRIVER_INITIALIZER
+ * @brief Constant initializer for a statically allocated driver.
+ *
+ * Wires the RX/TX rings to the embedded buffers at compile time, replacing
+ * the runtime part of uart_driver_init(). self is the object being defined,
+ * so the buffer addresses are link-time constants. Call uart_driver_start()
+ * once the UART peripheral is initialized.
+ *
+ * @code
+ * uart_driver_t console = UART_DRIVER_INITIALIZER(console, &huart1);
+ * @endcode
+ */
+#define UART_DRIVER_INITIALIZER(self, handle) {                                             \
+    .huart = (handle),                                                                      \
+    .backend = UART_DRIVER_BACKEND,                                                         \
+    .ring_buffer_rx = RING_BUFFER_INITIALIZER((self).rx_buffer, UART_DRIVER_RX_POLICY),     \
+    .ring_buffer_tx = UART_DRIVER_TX_RING_INITIALIZER((self).tx_buffer),                    \
+    .tx_busy = false,                                                                       \
+    .rx_mode = UART_DRIVER_RX_MODE,                                                         \
+    .rx_flow = { .high_water = UART_DRIVER_RX_HIGH_WATER,                                   \
+                 .low_water = UART_DRIVER_RX_LOW_WATER },                                   \
+    .tx_mode = UART_DRIVER_TX_MODE,                                                         \
+    .tx_deferred = UART_DRIVER_TX_DEFERRED,                                                 \
+    .tx_refs = ELEMENT_RING_INITIALIZER((self).tx_ref_storage),                             \
+}
+
+/**
+ * @brief Reads the cycle counter at interrupt entry.
+ *
+ * @return DWT cycle count.
+ */
+static inline uint32_t uart_driver_profile_begin(void) {
+    return DWT->CYCCNT;
+}
+
+/**
+ * @brief Accounts an interrupt started at uart_driver_profile_begin().
+ *
+ * @param uart_driver Pointer to uart_driver_t structure, may be NULL.
+ * @param start Cycle count returned by uart_driver_profile_begin().
+ */
+static inline void uart_driver_profile_end(uart_driver_t *uart_driver, uint32_t start) {
+    uint32_t cycles = DWT->CYCCNT - start;
+
+    if (uart_driver == NULL) {
+        return;
+    }
+
+    uart_driver->profile.irqs++;
+    uart_driver->profile.cycles += cycles;
+    if (cycles > uart_driver->profile.max_cycles) {
+        uart_driver->profile.max_cycles = cycles;
+    }
+}
+
+/**
+ * @brief Register-level UART interrupt handler.
+ *
+ * Call this first in the USARTx_IRQHandler. With the register backend it
+ * reads DR on RXNE into the RX ring and feeds DR from the TX ring on TXE,
+ * without going through HAL.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @return true if the interrupt was handled, false if the driver uses the
+ *         HAL backend and HAL_UART_IRQHandler() must run instead.
+ */
+bool uart_driver_irq_handler(uart_driver_t *uart_driver);
+
 /**
  * @brief UART RX interrupt callback.
  *
@@ -60,15 +449,40 @@ typedef struct uart_driver_ {
  */
 void uart_driver_rx_it_callback(uart_driver_t *uart_driver);
 
+/**
+ * @brief UART RX event callback for circular DMA reception.
+ *
+ * Call this from HAL_UARTEx_RxEventCallback(). Runs once per half buffer,
+ * full buffer or idle line, not once per byte.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param position Offset in the RX buffer the DMA stream has written up to.
+ */
+void uart_driver_rx_event_callback(uart_driver_t *uart_driver, uint16_t position);
+
 /**
  * @brief UART TX interrupt callback.
  *
- * Call this from the UART TX complete interrupt handler.
+ * Call this from the UART TX complete interrupt handler (HAL_UART_TxCpltCallback),
+ * in both IT and DMA mode.
  *
  * @param uart_driver Pointer to uart_driver_t structure.
  */
 void uart_driver_tx_it_callback(uart_driver_t *uart_driver);
 
+/**
+ * @brief UART error callback.
+ *
+ * Call this from HAL_UART_ErrorCallback(). Counts the errors HAL reports
+ * and re-arms reception if HAL stopped it, which it does on overrun and on
+ * any error in DMA RX mode. A DMA RX restart begins at the start of the
+ * buffer, so unread bytes are discarded. A TX transfer ended by a DMA error
+ * is dropped and the rest of the TX ring sent.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ */
+void uart_driver_error_callback(uart_driver_t *uart_driver);
+
 /**
  * @brief Initializes the UART driver.
  *
@@ -80,10 +494,212 @@ void uart_driver_tx_it_callback(uart_driver_t *uart_driver);
  */
 bool uart_driver_init(uart_driver_t *uart_driver, UART_HandleTypeDef *huart);
 
+/**
+ * @brief Starts reception on an already wired driver.
+ *
+ * For drivers defined with UART_DRIVER_INITIALIZER(); uart_driver_init()
+ * calls it itself.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @return true if reception was started, false otherwise.
+ */
+bool uart_driver_start(uart_driver_t *uart_driver);
+
+/**
+ * @brief Registers a driver for interrupt dispatch by USART instance.
+ *
+ * uart_driver_start() calls it, so a driver can be found with
+ * uart_driver_lookup() once it is started. Registering the same driver
+ * again is allowed.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @return true if registered, false if another driver owns the instance.
+ */
+bool uart_driver_register(uart_driver_t *uart_driver);
+
+/**
+ * @brief Finds the driver registered for a USART instance.
+ *
+ * Constant time, for the HAL callbacks and IRQ handlers:
+ * @code
+ * void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart) {
+ *     uart_driver_tx_it_callback(uart_driver_lookup(huart->Instance));
+ * }
+ * @endcode
+ *
+ * @param instance USART registers, e.g. USART2 or huart->Instance.
+ * @return Driver, or NULL if none is registered for the instance.
+ */
+uart_driver_t *uart_driver_lookup(const USART_TypeDef *instance);
+
+/**
+ * @brief Copies the interrupt cost measured so far.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param profile Pointer to store the measurement.
+ * @return true if copied, false if arguments are invalid.
+ */
+bool uart_driver_get_profile(uart_driver_t *uart_driver, uart_driver_profile_t *profile);
+
+/**
+ * @brief Clears the interrupt cost measurement.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @return true if cleared, false otherwise.
+ */
+bool uart_driver_reset_profile(uart_driver_t *uart_driver);
+
+/**
+ * @brief Selects interrupt or DMA transmission.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param mode New TX mode.
+ * @return true if switched, false if a transfer is in flight, DMA was
+ *         requested without a TX DMA stream or with the register backend,
+ *         or arguments are invalid.
+ */
+bool uart_driver_set_tx_mode(uart_driver_t *uart_driver, uart_driver_tx_mode_t mode);
+
+/**
+ * @brief Enables or disables write-combining of output.
+ *
+ * While enabled, uart_driver_send() and uart_driver_tx_commit() only queue
+ * their bytes; the transmitter starts on uart_driver_tx_kick(), when the
+ * TX ring reaches UART_DRIVER_TX_KICK_THRESHOLD, when a send does not fit,
+ * or from uart_driver_flush(). Bursts of small writes, e.g. a line being
+ * redrawn one character at a time, then leave as one DMA transfer instead
+ * of one per write. A transfer already in flight still picks up whatever
+ * was queued behind it when it completes. In TX IT mode and with the
+ * register backend every byte is its own interrupt anyway, so only the
+ * start of the burst is delayed.
+ *
+ * Output queued from interrupts waits for the next kick as well, so the
+ * main loop must call uart_driver_tx_kick() regularly.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param enable true to defer, false to start on every send again (queued output is kicked).
+ * @return true if applied, false if arguments are invalid.
+ */
+bool uart_driver_set_tx_deferred(uart_driver_t *uart_driver, bool enable);
+
+/**
+ * @brief Starts sending whatever is queued, if the transmitter is idle.
+ *
+ * The other half of uart_driver_set_tx_deferred(); cheap when there is
+ * nothing to send or a transfer is already in flight.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ */
+void uart_driver_tx_kick(uart_driver_t *uart_driver);
+
+/**
+ * @brief Enables or disables RTS/CTS hardware flow control.
+ *
+ * CTS is handled by the USART: transmission pauses at the next frame
+ * boundary while the peer deasserts it, in every TX mode. RTS is a GPIO
+ * output driven by the driver: deasserted (high) when the RX ring reaches
+ * UART_DRIVER_RX_HIGH_WATER and asserted again once the application has
+ * read it down to UART_DRIVER_RX_LOW_WATER.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param enable true to enable, false to disable and leave RTS asserted.
+ * @param rts_port RTS output port, already configured as an output, or NULL for CTS only.
+ * @param rts_pin RTS output pin.
+ * @return true if applied, false if arguments are invalid.
+ */
+bool uart_driver_set_flow_control(uart_driver_t *uart_driver, bool enable, GPIO_TypeDef *rts_port, uint16_t rts_pin);
+
+/**
+ * @brief Enables or disables XON/XOFF software flow control.
+ *
+ * XOFF is sent ahead of any queued output when the RX ring reaches
+ * UART_DRIVER_RX_HIGH_WATER, and XON once the application has read it down
+ * to UART_DRIVER_RX_LOW_WATER. XOFF from the peer pauses the TX ring drain
+ * until XON; the transfer in flight still completes. In IT RX mode the two
+ * characters are filtered out of the received data; in DMA RX mode they
+ * stay in the RX ring, so binary data cannot be carried.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param enable true to enable, false to disable (a stopped peer gets XON).
+ * @return true if applied, false if arguments are invalid.
+ */
+bool uart_driver_set_xon_xoff(uart_driver_t *uart_driver, bool enable);
+
+/**
+ * @brief Gets the flow control counters.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param stats Pointer to store the counters.
+ * @return true if successful, false if arguments are invalid.
+ */
+bool uart_driver_get_flow_stats(uart_driver_t *uart_driver, uart_driver_flow_stats_t *stats);
+
+/**
+ * @brief Copies the receive and DMA error counters.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param errors Pointer to store the counters.
+ * @return true if copied, false if arguments are invalid.
+ */
+bool uart_driver_get_errors(uart_driver_t *uart_driver, uart_driver_errors_t *errors);
+
+/**
+ * @brief Clears the receive and DMA error counters.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @return true if cleared, false otherwise.
+ */
+bool uart_driver_reset_errors(uart_driver_t *uart_driver);
+
+/**
+ * @brief Copies the traffic and buffer usage counters.
+ *
+ * Compare the ring high-water marks with UART_DRIVER_MAX_RX_BUFFER and
+ * UART_DRIVER_MAX_TX_BUFFER to size the rings, and tx_busy_ms with
+ * elapsed_ms to see how close TX runs to line rate.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param stats Pointer to store the counters.
+ * @return true if copied, false if arguments are invalid.
+ */
+bool uart_driver_get_stats(uart_driver_t *uart_driver, uart_driver_stats_t *stats);
+
+/**
+ * @brief Clears the traffic and buffer usage counters, including the ring
+ * dropped counts and high-water marks.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @return true if cleared, false otherwise.
+ */
+bool uart_driver_reset_stats(uart_driver_t *uart_driver);
+
+/**
+ * @brief Checks whether the USART can generate a baud rate.
+ *
+ * Works from the USART kernel clock (PCLK2 for USART1/USART6, PCLK1
+ * otherwise) and the BRR value HAL would program. 16x oversampling is
+ * preferred for its noise margin; 8x is used when the rate is above
+ * PCLK / 16 or only 8x gets within UART_DRIVER_BAUD_TOLERANCE.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param baud_rate Requested baud rate.
+ * @param actual Optional, set to the closest rate generated, 0 if out of range.
+ * @param oversampling Optional, set to UART_OVERSAMPLING_16 or UART_OVERSAMPLING_8.
+ * @return true if the rate is within tolerance, false otherwise.
+ */
+bool uart_driver_check_baud(uart_driver_t *uart_driver, uint32_t baud_rate, uint32_t *actual, uint32_t *oversampling);
+
 /**
  * @brief Reconfigures the UART driver baud rate.
  *
- * Aborts ongoing transfers, deinitializes and reinitializes UART with new baud rate.
+ * Validates the rate with uart_driver_check_baud() and lets queued output
+ * finish at the old rate (uart_driver_flush()) before deinitializing and
+ * reinitializing the UART with the new rate and oversampling. The drain
+ * gets the line time of a full TX ring plus the blocks queued by
+ * reference. Output still queued when it times out, e.g. held back by CTS
+ * or XOFF, is discarded. In DMA RX mode, received bytes not yet read are
+ * discarded.
+ * Call it from thread mode, or the drain is skipped.
  *
  * @param uart_driver Pointer to uart_driver_t structure.
  * @param baud_rate New baud rate.
@@ -92,9 +708,13 @@ bool uart_driver_init(uart_driver_t *uart_driver, UART_HandleTypeDef *huart);
 bool uart_driver_reconfigure(uart_driver_t *uart_driver, uint32_t baud_rate);
 
 /**
- * @brief Sends data over the UART driver.
+ * @brief Sends data over the UART driver without waiting.
  *
- * Pushes data into TX ring buffer and starts transmission if not busy.
+ * Copies data into the TX ring buffer in at most two blocks and starts
+ * transmission if not busy, unless write-combining defers it (see
+ * uart_driver_set_tx_deferred()). Bytes that do not fit are not queued. With UART_DRIVER_TX_MULTI_PRODUCER it may be
+ * called from any context, and each call's data stays contiguous in the
+ * output; otherwise it must only be called from a single context.
  *
  * @param uart_driver Pointer to uart_driver_t structure.
  * @param data Pointer to data buffer.
@@ -103,6 +723,93 @@ bool uart_driver_reconfigure(uart_driver_t *uart_driver, uint32_t baud_rate);
  */
 size_t uart_driver_send(uart_driver_t *uart_driver, uint8_t *data, size_t length);
 
+/**
+ * @brief Queues a block for transmission by reference, without copying it.
+ *
+ * The transmitter streams the block from where it is, after everything
+ * queued before the call and before anything queued after it: DMA mode
+ * sends it in transfers of up to 65535 bytes, IT mode and the register
+ * backend byte by byte. It takes no TX ring space, so it is not limited
+ * by UART_DRIVER_MAX_TX_BUFFER, e.g. const text in flash. The memory must
+ * stay valid and unchanged until it has been sent (uart_driver_flush()),
+ * and readable by the TX DMA stream (flash or SRAM, not CCM RAM).
+ *
+ * Thread mode only; from an interrupt it returns false, as it does when
+ * UART_DRIVER_TX_REF_QUEUE blocks are already queued. The caller then
+ * copies the data with uart_driver_send() or uart_driver_send_timeout().
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param data Block to send.
+ * @param length Number of bytes.
+ * @return true if queued, false otherwise.
+ */
+bool uart_driver_send_ref(uart_driver_t *uart_driver, const uint8_t *data, size_t length);
+
+/**
+ * @brief Sends data, waiting for TX ring space until all of it is queued.
+ *
+ * Queues what fits, then runs the idle hook and retries as the transmitter
+ * frees space, so output larger than the TX ring streams out at line rate
+ * instead of being cut. In interrupt context or with interrupts masked the
+ * transmitter cannot make progress, so it queues what fits and returns.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param data Pointer to data buffer.
+ * @param length Number of bytes to send.
+ * @param timeout_ms Maximum time to wait in milliseconds, 0 to not wait, or
+ *                   UART_DRIVER_WAIT_FOREVER.
+ * @return Number of bytes accepted for transmission, less than length on timeout.
+ */
+size_t uart_driver_send_timeout(uart_driver_t *uart_driver, uint8_t *data, size_t length, uint32_t timeout_ms);
+
+/**
+ * @brief Waits until everything queued has left the line.
+ *
+ * Returns once the TX ring is empty and the transmission complete flag
+ * shows the last stop bit has been sent, e.g. before changing the baud
+ * rate or entering a low-power mode.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param timeout_ms Maximum time to wait in milliseconds, or UART_DRIVER_WAIT_FOREVER.
+ * @return true if the transmitter is idle, false on timeout, when called
+ *         where it cannot wait, or if arguments are invalid.
+ */
+bool uart_driver_flush(uart_driver_t *uart_driver, uint32_t timeout_ms);
+
+/**
+ * @brief Sets the function run while uart_driver_send_timeout() or uart_driver_flush() wait.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param hook Function to run, NULL to busy-wait.
+ * @param context Argument passed to hook.
+ * @return true if set, false otherwise.
+ */
+bool uart_driver_set_idle_hook(uart_driver_t *uart_driver, uart_driver_idle_hook_t hook, void *context);
+
+/**
+ * @brief Gets the largest contiguous free region of the TX ring buffer.
+ *
+ * Lets a formatter write output straight into the TX ring. Single producer
+ * only, so it returns 0 when UART_DRIVER_TX_MULTI_PRODUCER is enabled and
+ * the caller should fall back to uart_driver_send().
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param region Pointer to store the start of the writable region.
+ * @return Size of the region in bytes.
+ */
+size_t uart_driver_tx_acquire(uart_driver_t *uart_driver, uint8_t **region);
+
+/**
+ * @brief Queues bytes written into a region from uart_driver_tx_acquire().
+ *
+ * Starts transmission if not busy, as uart_driver_send() does.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param length Number of bytes written into the region.
+ * @return true if the bytes were queued, false otherwise.
+ */
+bool uart_driver_tx_commit(uart_driver_t *uart_driver, size_t length);
+
 /**
  * @brief Get a single received byte from the RX ring buffer.
  *
@@ -112,4 +819,34 @@ size_t uart_driver_send(uart_driver_t *uart_driver, uint8_t *data, size_t length
  */
 bool uart_driver_get_byte(uart_driver_t *uart_driver, uint8_t *byte);
 
+/**
+ * @brief Get up to length received bytes from the RX ring buffer.
+ *
+ * Copies in at most two contiguous blocks instead of one call per byte.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param buffer Pointer to destination buffer.
+ * @param length Maximum number of bytes to read.
+ * @return Number of bytes copied into buffer.
+ */
+size_t uart_driver_get_bytes(uart_driver_t *uart_driver, uint8_t *buffer, size_t length);
+
+/**
+ * @brief Finds a byte in the received data without consuming it.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param byte Byte to look for, e.g. a line terminator.
+ * @param position Pointer to store the number of bytes received before it.
+ * @return true if the byte has been received, false otherwise.
+ */
+bool uart_driver_find_byte(uart_driver_t *uart_driver, uint8_t byte, size_t *position);
+
+/**
+ * @brief Gets the number of received bytes waiting to be read.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @return Byte count, 0 if arguments are invalid.
+ */
+size_t uart_driver_rx_available(uart_driver_t *uart_driver);
+
 #endif /* __UART_DRIVER_INC_ */
@@ -0,0 +1,148 @@
+/**
+ * @file element_ring.h
+ * @brief Fixed element-size ring buffer for embedded systems.
+ *
+ * Generic counterpart of ring_buffer_t for queueing events, timestamps or
+ * log records from an ISR. The element size is set at init and elements
+ * are always enqueued and dequeued whole.
+ *
+ * Same single-producer/single-consumer guarantees as ring_buffer_t: only the
+ * producer writes the head index and only the consumer writes the tail
+ * index, and the indices run over [0, 2 * capacity) so the whole capacity
+ * is usable without a shared full flag.
+ *
+ * @author Santiago Rincon
+ * @date 2026
+ */
+
+#ifndef __ELEMENT_RING_H__
+#define __ELEMENT_RING_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Ring buffer structure for fixed-size elements.
+ *
+ * Use element_ring_init() to initialize before use.
+ */
+typedef struct element_ring_ {
+    uint8_t *buffer;        /**< Pointer to buffer memory (capacity * element_size bytes) */
+    size_t head;            /**< Write index in elements, only modified by the producer */
+    size_t tail;            /**< Read index in elements, only modified by the consumer */
+    size_t capacity;        /**< Number of elements the buffer can hold */
+    size_t element_size;    /**< Size of one element in bytes */
+
+} element_ring_t;
+
+/**
+ * @def ELEMENT_RING_INITIALIZER
+ * @brief Constant initializer for an element ring over a statically sized array.
+ *
+ * Equivalent to element_ring_init() with the array's element size and
+ * count, but evaluated at compile time. storage must be an array, not a
+ * pointer.
+ */
+#define ELEMENT_RING_INITIALIZER(storage) {                                                 \
+    .buffer = (uint8_t *)(storage),                                                         \
+    .head = 0U,                                                                             \
+    .tail = 0U,                                                                             \
+    .capacity = sizeof(storage) / sizeof((storage)[0]),                                     \
+    .element_size = sizeof((storage)[0]),                                                   \
+}
+
+/**
+ * @brief Initializes an element ring.
+ *
+ * @param er Pointer to element ring structure.
+ * @param buf Pointer to buffer memory, at least element_size * element_count bytes.
+ * @param element_size Size of one element in bytes.
+ * @param element_count Number of elements the buffer can hold.
+ * @return true if initialization is successful, false otherwise.
+ */
+bool element_ring_init(element_ring_t *er, void *buf, size_t element_size, size_t element_count);
+
+/**
+ * @brief Enqueues one element.
+ *
+ * Producer side.
+ *
+ * @param er Pointer to element ring structure.
+ * @param element Pointer to element_size bytes to copy in.
+ * @return true if the element was stored, false if full or arguments are invalid.
+ */
+bool element_ring_push(element_ring_t *er, const void *element);
+
+/**
+ * @brief Dequeues one element.
+ *
+ * Consumer side.
+ *
+ * @param er Pointer to element ring structure.
+ * @param element Pointer to element_size bytes to copy out to.
+ * @return true if an element was read, false if empty or arguments are invalid.
+ */
+bool element_ring_pop(element_ring_t *er, void *element);
+
+/**
+ * @brief Enqueues up to count elements.
+ *
+ * Producer side. Copies whole elements using at most two memcpy segments
+ * and publishes them all at once.
+ *
+ * @param er Pointer to element ring structure.
+ * @param elements Pointer to an array of count elements.
+ * @param count Number of elements to enqueue.
+ * @return Number of elements stored.
+ */
+size_t element_ring_write(element_ring_t *er, const void *elements, size_t count);
+
+/**
+ * @brief Dequeues up to count elements.
+ *
+ * Consumer side. Copies whole elements using at most two memcpy segments
+ * and releases them all at once.
+ *
+ * @param er Pointer to element ring structure.
+ * @param elements Pointer to an array with room for count elements.
+ * @param count Maximum number of elements to dequeue.
+ * @return Number of elements read.
+ */
+size_t element_ring_read(element_ring_t *er, void *elements, size_t count);
+
+/**
+ * @brief Checks if the element ring is empty.
+ *
+ * @param er Pointer to element ring structure.
+ * @return true if empty, false otherwise.
+ */
+bool element_ring_is_empty(element_ring_t *er);
+
+/**
+ * @brief Resets the element ring to empty state.
+ *
+ * Not safe while a producer or consumer is active on the ring.
+ *
+ * @param er Pointer to element ring structure.
+ * @return true if successful, false otherwise.
+ */
+bool element_ring_reset(element_ring_t *er);
+
+/**
+ * @brief Gets the number of elements the ring can hold.
+ *
+ * @param er Pointer to element ring structure.
+ * @return Capacity in elements.
+ */
+size_t element_ring_get_capacity(element_ring_t *er);
+
+/**
+ * @brief Gets the number of elements currently stored.
+ *
+ * @param er Pointer to element ring structure.
+ * @return Number of stored elements.
+ */
+size_t element_ring_get_count(element_ring_t *er);
+
+#endif // __ELEMENT_RING_H__
@@ -0,0 +1,82 @@
+/**
+ * @file flow_control.h
+ * @brief Watermark hysteresis for receive flow control.
+ *
+ * Decides when a receiver should ask its peer to stop sending and when to
+ * let it resume, from the fill level of its receive buffer: stop once the
+ * level reaches the high-water mark, resume once the consumer has drained
+ * it down to the low-water mark. The gap between the two keeps the line
+ * from toggling on every byte.
+ *
+ * The signalling itself (an RTS pin, XOFF/XON characters) is left to the
+ * caller, so the same logic runs on the target and in host simulations.
+ *
+ * The producer (the RX interrupt) only ever calls flow_control_on_produce()
+ * and the consumer only flow_control_on_consume(). The producer may preempt
+ * the consumer, so the consumer side has to run with the producer masked.
+ *
+ * @author Santiago Rincon
+ * @date 2026
+ */
+
+#ifndef __FLOW_CONTROL_H__
+#define __FLOW_CONTROL_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Flow control state of one receiver.
+ *
+ * Use flow_control_init() to initialize before use.
+ */
+typedef struct flow_control_ {
+    size_t high_water;      /**< Fill level at which the peer is stopped */
+    size_t low_water;       /**< Fill level at which the peer may resume */
+    volatile bool stopped;  /**< Peer has been asked to stop */
+    uint32_t stop_count;    /**< Number of times the peer was stopped */
+
+} flow_control_t;
+
+/**
+ * @brief Initializes flow control with the peer allowed to send.
+ *
+ * @param fc Pointer to flow control structure.
+ * @param low_water Fill level at which the peer may resume.
+ * @param high_water Fill level at which the peer is stopped, above low_water.
+ * @return true if initialization is successful, false otherwise.
+ */
+bool flow_control_init(flow_control_t *fc, size_t low_water, size_t high_water);
+
+/**
+ * @brief Checks the fill level after data was received.
+ *
+ * Producer side.
+ *
+ * @param fc Pointer to flow control structure.
+ * @param level Current fill level of the receive buffer.
+ * @return true if the peer must be stopped now, false otherwise.
+ */
+bool flow_control_on_produce(flow_control_t *fc, size_t level);
+
+/**
+ * @brief Checks the fill level after data was consumed.
+ *
+ * Consumer side.
+ *
+ * @param fc Pointer to flow control structure.
+ * @param level Current fill level of the receive buffer.
+ * @return true if the peer may resume now, false otherwise.
+ */
+bool flow_control_on_consume(flow_control_t *fc, size_t level);
+
+/**
+ * @brief Tells whether the peer is currently stopped.
+ *
+ * @param fc Pointer to flow control structure.
+ * @return true if stopped, false otherwise.
+ */
+bool flow_control_is_stopped(const flow_control_t *fc);
+
+#endif /* __FLOW_CONTROL_H__ */
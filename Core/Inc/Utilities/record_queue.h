@@ -0,0 +1,118 @@
+/**
+ * @file record_queue.h
+ * @brief Variable-length record queue built on the byte ring buffer.
+ *
+ * Each record is stored as a 16-bit length prefix followed by its payload.
+ * Records are never split across the wrap point (bip-buffer style): when a
+ * record does not fit before the end of the buffer the producer commits the
+ * remaining bytes as padding and starts the record at offset 0. The consumer
+ * can therefore look at a record in place with record_queue_peek().
+ *
+ * Inherits the single-producer/single-consumer guarantees of ring_buffer_t.
+ *
+ * @author Santiago Rincon
+ * @date 2026
+ */
+
+#ifndef __RECORD_QUEUE_H__
+#define __RECORD_QUEUE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "ring_buffer.h"
+
+/**
+ * @def RECORD_QUEUE_HEADER_SIZE
+ * @brief Size of the length prefix stored in front of every record.
+ */
+#define RECORD_QUEUE_HEADER_SIZE    (sizeof(uint16_t))
+
+/**
+ * @def RECORD_QUEUE_MAX_RECORD
+ * @brief Largest payload a single record may carry.
+ */
+#define RECORD_QUEUE_MAX_RECORD     (0xFFFEU)
+
+/**
+ * @brief Variable-length record queue structure.
+ *
+ * Use record_queue_init() to initialize before use.
+ */
+typedef struct record_queue_ {
+    ring_buffer_t ring;     /**< Underlying byte ring buffer */
+
+} record_queue_t;
+
+/**
+ * @brief Initializes a record queue.
+ *
+ * Power-of-two sizes use the masked ring buffer mode. A record needs
+ * RECORD_QUEUE_HEADER_SIZE + length contiguous bytes; only records up to
+ * half the buffer (header included) are guaranteed to fit once it drains.
+ *
+ * @param rq Pointer to record queue structure.
+ * @param buf Pointer to buffer memory.
+ * @param size Size of buffer in bytes.
+ * @return true if initialization is successful, false otherwise.
+ */
+bool record_queue_init(record_queue_t *rq, uint8_t *buf, size_t size);
+
+/**
+ * @brief Enqueues one record.
+ *
+ * Producer side. The record is stored whole or not at all.
+ *
+ * @param rq Pointer to record queue structure.
+ * @param record Pointer to payload.
+ * @param length Payload length, at most RECORD_QUEUE_MAX_RECORD.
+ * @return true if the record was stored, false if there is no room or arguments are invalid.
+ */
+bool record_queue_push(record_queue_t *rq, const void *record, size_t length);
+
+/**
+ * @brief Looks at the oldest record in place without dequeuing it.
+ *
+ * Consumer side. The payload stays valid until record_queue_release().
+ *
+ * @param rq Pointer to record queue structure.
+ * @param record Pointer to store the payload address.
+ * @param length Pointer to store the payload length.
+ * @return true if a record is available, false if empty or arguments are invalid.
+ */
+bool record_queue_peek(record_queue_t *rq, const uint8_t **record, size_t *length);
+
+/**
+ * @brief Dequeues the record returned by record_queue_peek().
+ *
+ * @param rq Pointer to record queue structure.
+ * @return true if a record was released, false if empty or arguments are invalid.
+ */
+bool record_queue_release(record_queue_t *rq);
+
+/**
+ * @brief Dequeues the oldest record into a caller buffer.
+ *
+ * Consumer side. If the payload does not fit, nothing is dequeued and
+ * length reports the size needed.
+ *
+ * @param rq Pointer to record queue structure.
+ * @param dst Pointer to destination buffer.
+ * @param dst_size Size of destination buffer.
+ * @param length Pointer to store the payload length.
+ * @return true if a record was copied and dequeued, false otherwise.
+ */
+bool record_queue_pop(record_queue_t *rq, void *dst, size_t dst_size, size_t *length);
+
+/**
+ * @brief Checks if the record queue is empty.
+ *
+ * Consumer side, since it skips any padding at the front of the queue.
+ *
+ * @param rq Pointer to record queue structure.
+ * @return true if empty, false otherwise.
+ */
+bool record_queue_is_empty(record_queue_t *rq);
+
+#endif // __RECORD_QUEUE_H__
@@ -2,9 +2,35 @@
  * @file ring_buffer.h
  * @brief Generic byte ring buffer for embedded systems.
  *
- * Provides a circular buffer implementation with overwrite-on-full,
+ * Provides a lock-free single-producer/single-consumer (SPSC) circular buffer,
  * and utility functions for buffer management and status.
  *
+ * Only the producer writes the head index and only the consumer writes the
+ * tail index, so one context (e.g. the main loop) may push while another
+ * (e.g. a UART ISR) pops without disabling interrupts. The indices run over
+ * [0, 2 * capacity) so a full buffer can be told apart from an empty one
+ * without a shared flag, and the whole capacity is usable.
+ *
+ * Buffers initialized with ring_buffer_init_pow2() require a power-of-two
+ * capacity and use free-running indices wrapped with a mask, so the per-byte
+ * path never needs a division or a compare-and-subtract.
+ *
+ * What happens when the producer outruns the consumer is selected per
+ * instance with ring_buffer_set_policy(). Each instance counts the bytes it
+ * dropped and the highest fill level it reached, to size buffers from data.
+ *
+ * ring_buffer_push_fast() and ring_buffer_pop_fast() are unchecked inline
+ * versions of push/pop for per-byte callers such as UART interrupts.
+ *
+ * RING_BUFFER_DEFINE() declares a ring together with its storage as a
+ * statically initialized object, so no init call is needed at startup.
+ *
+ * A power-of-two buffer can be switched to multi-producer mode with
+ * ring_buffer_set_multi_producer(), so several contexts (ISRs at any
+ * priority and the main loop) may write concurrently. Producers reserve
+ * space with a compare-and-swap and the last one to finish publishes the
+ * head, so no producer waits on another. The consumer side is unchanged.
+ *
  * @author Santiago Rincon
  * @date 2025
  */
@@ -16,6 +42,113 @@
 #include <stdbool.h>
 #include <stddef.h>
 
+/**
+ * @def RING_BUFFER_IS_POW2
+ * @brief Evaluates to true if n is a non-zero power of two. Usable in constant expressions.
+ */
+#define RING_BUFFER_IS_POW2(n) (((n) != 0U) && (((n) & ((n) - 1U)) == 0U))
+
+/**
+ * @def RING_BUFFER_ASSERT_POW2
+ * @brief Compile-time check that a constant buffer size can be used with ring_buffer_init_pow2().
+ */
+#define RING_BUFFER_ASSERT_POW2(size) \
+    _Static_assert(RING_BUFFER_IS_POW2(size), #size " must be a power of two")
+
+/**
+ * @def RING_BUFFER_STORAGE_ALIGN
+ * @brief Alignment of the storage declared by RING_BUFFER_DEFINE(), so DMA
+ * and word-wide copies can use it directly.
+ */
+#ifndef RING_BUFFER_STORAGE_ALIGN
+#define RING_BUFFER_STORAGE_ALIGN 4U
+#endif
+
+_Static_assert(RING_BUFFER_IS_POW2(RING_BUFFER_STORAGE_ALIGN), "RING_BUFFER_STORAGE_ALIGN must be a power of two");
+
+/**
+ * @def RING_BUFFER_INITIALIZER
+ * @brief Constant initializer for a ring buffer over a statically sized array.
+ *
+ * Equivalent to ring_buffer_init_pow2() (or ring_buffer_init() if the array
+ * size is not a power of two) followed by ring_buffer_set_policy(), but
+ * evaluated at compile time. storage must be an array, not a pointer.
+ */
+#define RING_BUFFER_INITIALIZER(storage, buffer_policy) \
+    RING_BUFFER_INITIALIZER_MODE(storage, buffer_policy, false)
+
+/**
+ * @def RING_BUFFER_MP_INITIALIZER
+ * @brief Constant initializer for a multi-producer ring buffer.
+ *
+ * Same as RING_BUFFER_INITIALIZER() followed by
+ * ring_buffer_set_multi_producer(). The array size must be a power of two.
+ */
+#define RING_BUFFER_MP_INITIALIZER(storage, buffer_policy) \
+    RING_BUFFER_INITIALIZER_MODE(storage, buffer_policy, true)
+
+/**
+ * @brief Common expansion of RING_BUFFER_INITIALIZER() and RING_BUFFER_MP_INITIALIZER().
+ */
+#define RING_BUFFER_INITIALIZER_MODE(storage, buffer_policy, shared) {                      \
+    .buffer = (storage),                                                                    \
+    .head = 0U,                                                                             \
+    .tail = 0U,                                                                             \
+    .capacity = sizeof(storage),                                                            \
+    .mask = RING_BUFFER_IS_POW2(sizeof(storage)) ? (sizeof(storage) - 1U) : 0U,             \
+    .policy = (buffer_policy),                                                              \
+    .dropped = 0U,                                                                          \
+    .high_water = 0U,                                                                       \
+    .multi_producer = (shared),                                                             \
+    .reserve = 0U,                                                                          \
+    .committed = 0U,                                                                        \
+}
+
+/**
+ * @def RING_BUFFER_DEFINE
+ * @brief Defines a power-of-two ring buffer named name and its aligned storage.
+ *
+ * The size is checked at compile time and the ring is ready to use without
+ * ring_buffer_init_pow2(). Use at file scope: the storage, name##_storage,
+ * is static and the ring itself is an ordinary definition.
+ *
+ * @code
+ * RING_BUFFER_DEFINE(log_ring, 512, RING_BUFFER_POLICY_OVERWRITE_OLDEST);
+ * @endcode
+ */
+#define RING_BUFFER_DEFINE(name, size, buffer_policy)                                       \
+    static uint8_t name##_storage[(size)] __attribute__((aligned(RING_BUFFER_STORAGE_ALIGN)));    \
+    _Static_assert(RING_BUFFER_IS_POW2(size), #name " size must be a power of two");        \
+    _Static_assert((size) <= (SIZE_MAX / 2U), #name " size is too large");                  \
+    ring_buffer_t name = RING_BUFFER_INITIALIZER(name##_storage, buffer_policy)
+
+/**
+ * @def RING_BUFFER_LOAD_ACQUIRE
+ * @brief Loads an index written by the other side of the buffer.
+ *
+ * The acquire ordering guarantees that the data published before the index
+ * was stored is visible once the new index value is observed.
+ */
+#define RING_BUFFER_LOAD_ACQUIRE(index)         __atomic_load_n(&(index), __ATOMIC_ACQUIRE)
+
+/**
+ * @def RING_BUFFER_STORE_RELEASE
+ * @brief Publishes an index owned by this side of the buffer.
+ *
+ * The release ordering guarantees that the data accesses done before the
+ * store are complete before the other side can observe the new index.
+ */
+#define RING_BUFFER_STORE_RELEASE(index, value) __atomic_store_n(&(index), (value), __ATOMIC_RELEASE)
+
+/**
+ * @brief Behaviour of the producer when the ring buffer is full.
+ */
+typedef enum {
+    RING_BUFFER_POLICY_DROP_NEWEST = 0,     /**< Keep unread data, discard what does not fit and count it (default) */
+    RING_BUFFER_POLICY_OVERWRITE_OLDEST,    /**< Discard the oldest unread data to make room and count it */
+    RING_BUFFER_POLICY_REJECT               /**< Keep unread data, store what fits and leave the rest to the caller */
+} ring_buffer_policy_t;
+
 /**
  * @brief Ring buffer structure for byte storage.
  *
@@ -23,10 +156,16 @@
  */
 typedef struct ring_buffer_ {
     uint8_t *buffer;    /**< Pointer to buffer memory */
-    size_t head;        /**< Write index */
-    size_t tail;        /**< Read index */
+    size_t head;        /**< Write index, only modified by the producer */
+    size_t tail;        /**< Read index, only modified by the consumer */
     size_t capacity;    /**< Size of buffer */
-    bool full;          /**< Buffer full flag */
+    size_t mask;        /**< capacity - 1 in power-of-two mode, 0 otherwise */
+    ring_buffer_policy_t policy;    /**< Overflow policy */
+    size_t dropped;     /**< Bytes discarded by the overflow policy */
+    size_t high_water;  /**< Highest number of bytes stored at once */
+    bool multi_producer;    /**< Producers reserve space through reserve/committed */
+    size_t reserve;     /**< Multi-producer mode: end of the space reserved by producers */
+    size_t committed;   /**< Multi-producer mode: total bytes copied in by producers */
 
 } ring_buffer_t;
 
@@ -40,26 +179,192 @@ typedef struct ring_buffer_ {
  */
 bool ring_buffer_init(ring_buffer_t *rb, uint8_t *buf, size_t size);
 
+/**
+ * @brief Initializes a ring buffer in power-of-two mode.
+ *
+ * Indices run freely and are wrapped with a mask. Pair with
+ * RING_BUFFER_ASSERT_POW2() when the size is a compile-time constant.
+ *
+ * @param rb Pointer to ring buffer structure.
+ * @param buf Pointer to buffer memory.
+ * @param size Size of buffer, must be a power of two.
+ * @return true if initialization is successful, false otherwise.
+ */
+bool ring_buffer_init_pow2(ring_buffer_t *rb, uint8_t *buf, size_t size);
+
+/**
+ * @brief Selects what the producer does when the ring buffer is full.
+ *
+ * Set it before the buffer is shared. RING_BUFFER_POLICY_OVERWRITE_OLDEST is
+ * not available in multi-producer mode. With RING_BUFFER_POLICY_OVERWRITE_OLDEST
+ * the producer moves the tail too, so the consumer releases bytes with a
+ * compare-and-swap and retries if they were overwritten while it read them;
+ * data obtained through ring_buffer_read_acquire() is then only valid if
+ * ring_buffer_read_commit() succeeds.
+ *
+ * @param rb Pointer to ring buffer structure.
+ * @param policy Overflow policy.
+ * @return true if successful, false otherwise.
+ */
+bool ring_buffer_set_policy(ring_buffer_t *rb, ring_buffer_policy_t policy);
+
+/**
+ * @brief Enables or disables multi-producer mode.
+ *
+ * Set it before the buffer is shared. In multi-producer mode
+ * ring_buffer_push() and ring_buffer_write() may be called from any number
+ * of contexts at once; each write lands contiguously in the stream. The
+ * zero-copy write_acquire/write_commit pair is not available, since a region
+ * cannot be held while other producers advance.
+ *
+ * @param rb Pointer to ring buffer structure.
+ * @param enable true to allow concurrent producers.
+ * @return true if successful, false if the buffer is not in power-of-two
+ *         mode, uses the overwrite policy, or arguments are invalid.
+ */
+bool ring_buffer_set_multi_producer(ring_buffer_t *rb, bool enable);
+
 /**
  * @brief Pushes a byte into the ring buffer.
  *
- * If the buffer is full, the oldest data is overwritten.
+ * Producer side. If the buffer is full the overflow policy decides whether
+ * the oldest byte is overwritten or the new one is not stored.
  *
  * @param rb Pointer to ring buffer structure.
  * @param data Byte to push.
- * @return true if successful, false otherwise.
+ * @return true if the byte was stored, false if buffer is full or arguments are invalid.
  */
 bool ring_buffer_push(ring_buffer_t *rb, uint8_t data);
 
 /**
  * @brief Pops a byte from the ring buffer.
  *
+ * Consumer side.
+ *
  * @param rb Pointer to ring buffer structure.
  * @param data Pointer to store popped byte.
  * @return true if successful, false if buffer is empty or arguments are invalid.
  */
 bool ring_buffer_pop(ring_buffer_t *rb, uint8_t *data);
 
+/**
+ * @brief Writes a block of bytes into the ring buffer.
+ *
+ * Producer side. Copies using at most two memcpy segments around the wrap
+ * point, and publishes them all at once. If the data does not fit the
+ * overflow policy decides which bytes are kept.
+ *
+ * @param rb Pointer to ring buffer structure.
+ * @param src Pointer to data to write.
+ * @param length Number of bytes to write.
+ * @return Number of bytes accepted: length when overwriting, otherwise the bytes that fit.
+ */
+size_t ring_buffer_write(ring_buffer_t *rb, const uint8_t *src, size_t length);
+
+/**
+ * @brief Reads a block of bytes from the ring buffer.
+ *
+ * Consumer side. Copies as many bytes as are available using at most two
+ * memcpy segments around the wrap point, and releases them all at once.
+ *
+ * @param rb Pointer to ring buffer structure.
+ * @param dst Pointer to destination buffer.
+ * @param length Maximum number of bytes to read.
+ * @return Number of bytes read.
+ */
+size_t ring_buffer_read(ring_buffer_t *rb, uint8_t *dst, size_t length);
+
+/**
+ * @brief Gets the largest contiguous writable region of the ring buffer.
+ *
+ * Producer side. Lets a formatter or DMA engine write straight into ring
+ * memory. Nothing becomes visible to the consumer until
+ * ring_buffer_write_commit() is called.
+ *
+ * @param rb Pointer to ring buffer structure.
+ * @param region Pointer to store the start of the writable region.
+ * @return Size of the region in bytes, 0 if the buffer is full, in
+ *         multi-producer mode, or arguments are invalid.
+ */
+size_t ring_buffer_write_acquire(ring_buffer_t *rb, uint8_t **region);
+
+/**
+ * @brief Publishes bytes written into a region from ring_buffer_write_acquire().
+ *
+ * @param rb Pointer to ring buffer structure.
+ * @param length Number of bytes written, at most the acquired region size.
+ * @return true if successful, false if length exceeds the free space or arguments are invalid.
+ */
+bool ring_buffer_write_commit(ring_buffer_t *rb, size_t length);
+
+/**
+ * @brief Publishes bytes a free-running producer already wrote at the head.
+ *
+ * For a circular DMA stream writing into the ring storage on its own: the
+ * stream never waits for the consumer, so when length exceeds the free space
+ * the oldest unread bytes have already been overwritten. They are discarded
+ * by moving the tail and counted as dropped. Requires the overwrite policy,
+ * so the consumer detects the moved tail instead of returning stale data.
+ * Bytes the producer overwrites before its next call are not seen here; the
+ * consumer drops those with ring_buffer_trim().
+ *
+ * @param rb Pointer to ring buffer structure.
+ * @param length Number of bytes written since the last call, at most capacity.
+ * @return true if successful, false if the policy is not overwrite, in
+ *         multi-producer mode, or arguments are invalid.
+ */
+bool ring_buffer_write_advance(ring_buffer_t *rb, size_t length);
+
+/**
+ * @brief Drops the oldest unread bytes so that at most count remain.
+ *
+ * Consumer side. For a free-running producer that writes ahead of what it
+ * has published, such as a circular DMA stream: the consumer drops what the
+ * producer is about to overwrite before reading. The tail moves with a
+ * compare-and-swap, so a producer moving it too retries; the dropped counter
+ * is a plain add, so mask the producer if it can drop bytes at the same time.
+ *
+ * @param rb Pointer to ring buffer structure.
+ * @param count Number of unread bytes to keep.
+ * @return Number of bytes dropped.
+ */
+size_t ring_buffer_trim(ring_buffer_t *rb, size_t count);
+
+/**
+ * @brief Gets the largest contiguous readable region of the ring buffer.
+ *
+ * Consumer side. Lets a DMA engine or scanner read straight from ring
+ * memory. The bytes stay owned by the consumer until
+ * ring_buffer_read_commit() releases them.
+ *
+ * @param rb Pointer to ring buffer structure.
+ * @param region Pointer to store the start of the readable region.
+ * @return Size of the region in bytes, 0 if the buffer is empty or arguments are invalid.
+ */
+size_t ring_buffer_read_acquire(ring_buffer_t *rb, uint8_t **region);
+
+/**
+ * @brief Releases bytes consumed from a region from ring_buffer_read_acquire().
+ *
+ * @param rb Pointer to ring buffer structure.
+ * @param length Number of bytes consumed, at most the bytes stored.
+ * @return true if successful, false if length exceeds the stored bytes or arguments are invalid.
+ */
+bool ring_buffer_read_commit(ring_buffer_t *rb, size_t length);
+
+/**
+ * @brief Finds the first occurrence of a byte in the unread data.
+ *
+ * Consumer side. Scans both wrap segments with memchr without consuming
+ * anything, e.g. to check whether a whole line has arrived.
+ *
+ * @param rb Pointer to ring buffer structure.
+ * @param value Byte to look for.
+ * @param position Pointer to store the number of bytes before the match.
+ * @return true if found, false if not found or arguments are invalid.
+ */
+bool ring_buffer_find(ring_buffer_t *rb, uint8_t value, size_t *position);
+
 /**
  * @brief Checks if the ring buffer is empty.
  *
@@ -79,6 +384,8 @@ bool ring_buffer_is_full(ring_buffer_t *rb);
 /**
  * @brief Resets the ring buffer to empty state.
  *
+ * Not safe while a producer or consumer is active on the buffer.
+ *
  * @param rb Pointer to ring buffer structure.
  * @return true if successful, false otherwise.
  */
@@ -100,4 +407,86 @@ size_t ring_buffer_get_capacity(ring_buffer_t *rb);
  */
 size_t ring_buffer_get_count(ring_buffer_t *rb);
 
+/**
+ * @brief Gets the number of bytes discarded by the overflow policy.
+ *
+ * @param rb Pointer to ring buffer structure.
+ * @return Dropped byte count since init or the last ring_buffer_reset_stats().
+ */
+size_t ring_buffer_get_dropped(ring_buffer_t *rb);
+
+/**
+ * @brief Gets the highest number of bytes stored at once.
+ *
+ * @param rb Pointer to ring buffer structure.
+ * @return High-water mark since init or the last ring_buffer_reset_stats().
+ */
+size_t ring_buffer_get_high_water(ring_buffer_t *rb);
+
+/**
+ * @brief Clears the dropped byte counter and the high-water mark.
+ *
+ * @param rb Pointer to ring buffer structure.
+ * @return true if successful, false otherwise.
+ */
+bool ring_buffer_reset_stats(ring_buffer_t *rb);
+
+/**
+ * @brief Pushes a byte into the ring buffer without argument checks.
+ *
+ * Producer side, inline fast path of ring_buffer_push() for per-byte hot
+ * paths. rb must point to an initialized ring buffer. Power-of-two buffers
+ * with free space take the inline path; a full buffer or a buffer in
+ * generic or multi-producer mode falls back to ring_buffer_push() so the
+ * overflow policy and statistics behave the same.
+ *
+ * @param rb Pointer to an initialized ring buffer structure.
+ * @param data Byte to push.
+ * @return true if the byte was stored, false if buffer is full.
+ */
+static inline bool ring_buffer_push_fast(ring_buffer_t *rb, uint8_t data) {
+    size_t head = rb->head;
+    size_t used = head - RING_BUFFER_LOAD_ACQUIRE(rb->tail);
+
+    if ((rb->mask == 0U) || rb->multi_producer || (used >= rb->capacity)) {
+        return ring_buffer_push(rb, data);
+    }
+
+    rb->buffer[head & rb->mask] = data;
+    RING_BUFFER_STORE_RELEASE(rb->head, head + 1U);
+
+    if (used >= rb->high_water) {
+        rb->high_water = used + 1U;
+    }
+    return true;
+}
+
+/**
+ * @brief Pops a byte from the ring buffer without argument checks.
+ *
+ * Consumer side, inline fast path of ring_buffer_pop(). rb and data must be
+ * valid. Buffers in generic mode or with the overwrite policy, where the
+ * tail has to be released with a compare-and-swap, fall back to
+ * ring_buffer_pop().
+ *
+ * @param rb Pointer to an initialized ring buffer structure.
+ * @param data Pointer to store popped byte.
+ * @return true if successful, false if buffer is empty.
+ */
+static inline bool ring_buffer_pop_fast(ring_buffer_t *rb, uint8_t *data) {
+    if ((rb->mask == 0U) || (rb->policy == RING_BUFFER_POLICY_OVERWRITE_OLDEST)) {
+        return ring_buffer_pop(rb, data);
+    }
+
+    size_t tail = rb->tail;
+
+    if (RING_BUFFER_LOAD_ACQUIRE(rb->head) == tail) {
+        return false;
+    }
+
+    *data = rb->buffer[tail & rb->mask];
+    RING_BUFFER_STORE_RELEASE(rb->tail, tail + 1U);
+    return true;
+}
+
 #endif // __RING_BUFFER_H__
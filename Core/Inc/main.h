@@ -69,6 +69,21 @@ void Error_Handler(void);
 /* USER CODE BEGIN Private defines */
 #define UART_SHELL_INSTANCE USART1
 
+/* RTS/CTS flow control on the shell UART, off by default as most USB-UART
+   adapters leave the lines unconnected */
+#ifndef SHELL_FLOW_CONTROL
+#define SHELL_FLOW_CONTROL 0
+#endif
+#define SHELL_CTS_Pin GPIO_PIN_11
+#define SHELL_CTS_GPIO_Port GPIOA
+#define SHELL_RTS_Pin GPIO_PIN_12
+#define SHELL_RTS_GPIO_Port GPIOA
+
+/* XON/XOFF flow control on the shell UART, for adapters without RTS/CTS */
+#ifndef SHELL_XON_XOFF
+#define SHELL_XON_XOFF 0
+#endif
+
 
 /* USER CODE END Private defines */
 
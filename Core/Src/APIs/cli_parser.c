@@ -3,7 +3,7 @@
  * @brief Command parser implementation for STM32 UART shell.
  *
  * This file implements the CLI command parsing and dispatch logic,
- * including help, clear, history, and version commands.
+ * including help, clear, history, version, isrprof, baud, and uartstat commands.
  * Each command handler validates its arguments and prints usage/help as needed.
  *
  * @author Santiago Rincon
@@ -13,10 +13,11 @@
 #include "cli_parser.h"
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include "target_ver.h"
 #include "shell.h"
 
-#define TOTAL_COMMANDS          (4U)    /**< Total number of available commands */
+#define TOTAL_COMMANDS          (7U)    /**< Total number of available commands */
 #define COMMAND_MAX_LENGTH      (10U)   /**< Maximum length of command name */
 #define CLI_MAX_ARGS            (5U)    /**< Maximum arguments per command */
 
@@ -24,13 +25,19 @@
 #define UNKNOWN_ARGUMENT_TEXT   "unknown argument"      /**< Error message for unknown arguments */
 #define UNKNOWN_ARGUMENT_SEQ    UNKNOWN_ARGUMENT_TEXT "%s " NEWLINE_SEQ  /**< Formatted unknown argument message */
 
+/** Sends a help text constant from flash as is, without formatting or copying it */
+#define CLI_SEND_TEXT(shell, text) ((void)shell_send_static((shell), (const uint8_t *)(text), sizeof(text) - 1U))
+
 // --- Help text constants ---
 static const char help_general_text[] =
     "Available commands:" NEWLINE_SEQ
-    TAB_SEQ "help    - Show this help" NEWLINE_SEQ
-    TAB_SEQ "clear   - Clear screen" NEWLINE_SEQ
-    TAB_SEQ "history - Show command history" NEWLINE_SEQ
-    TAB_SEQ "version - Show version info" NEWLINE_SEQ
+    TAB_SEQ "help     - Show this help" NEWLINE_SEQ
+    TAB_SEQ "clear    - Clear screen" NEWLINE_SEQ
+    TAB_SEQ "history  - Show command history" NEWLINE_SEQ
+    TAB_SEQ "version  - Show version info" NEWLINE_SEQ
+    TAB_SEQ "isrprof  - Show UART interrupt cycles" NEWLINE_SEQ
+    TAB_SEQ "baud     - Show or change the baud rate" NEWLINE_SEQ
+    TAB_SEQ "uartstat - Show UART traffic, buffer and error counters" NEWLINE_SEQ
     "Type 'help <command>' for details on a specific command." NEWLINE_SEQ NEWLINE_SEQ;
 
 static const char help_clear_text[] =
@@ -45,6 +52,21 @@ static const char help_version_text[] =
     "version: Shows firmware version information." NEWLINE_SEQ
     TAB_SEQ "Usage: version (no params)" NEWLINE_SEQ NEWLINE_SEQ;
 
+static const char help_isrprof_text[] =
+    "isrprof: Shows UART interrupt cost measured with the DWT cycle counter." NEWLINE_SEQ
+    TAB_SEQ "Usage: isrprof [reset]" NEWLINE_SEQ
+    TAB_SEQ "Bytes and cycles per byte need a build with UART_DRIVER_PROFILE=1." NEWLINE_SEQ NEWLINE_SEQ;
+
+static const char help_baud_text[] =
+    "baud: Shows or changes the UART baud rate. Pending output is sent first." NEWLINE_SEQ
+    TAB_SEQ "Usage: baud [<rate> [try] | ok]" NEWLINE_SEQ
+    TAB_SEQ "try: revert unless 'baud ok' is entered at the new rate in time." NEWLINE_SEQ
+    TAB_SEQ "Rates above PCLK2/16 use 8x oversampling (up to PCLK2/8)." NEWLINE_SEQ NEWLINE_SEQ;
+
+static const char help_uartstat_text[] =
+    "uartstat: Shows UART traffic, ring usage, errors and flow control since the last reset." NEWLINE_SEQ
+    TAB_SEQ "Usage: uartstat [reset]" NEWLINE_SEQ NEWLINE_SEQ;
+
 // --- Command handler prototypes ---
 /**
  * @brief Handle the 'help' command.
@@ -78,8 +100,32 @@ static void cli_cmd_history(shell_t *shell, int argc, char **argv);
  */
 static void cli_cmd_version(shell_t *shell, int argc, char **argv);
 
+/**
+ * @brief Handle the 'isrprof' command.
+ * @param shell Pointer to the shell instance.
+ * @param argc Argument count.
+ * @param argv Argument vector.
+ */
+static void cli_cmd_isrprof(shell_t *shell, int argc, char **argv);
+
+/**
+ * @brief Handle the 'baud' command.
+ * @param shell Pointer to the shell instance.
+ * @param argc Argument count.
+ * @param argv Argument vector.
+ */
+static void cli_cmd_baud(shell_t *shell, int argc, char **argv);
+
+/**
+ * @brief Handle the 'uartstat' command.
+ * @param shell Pointer to the shell instance.
+ * @param argc Argument count.
+ * @param argv Argument vector.
+ */
+static void cli_cmd_uartstat(shell_t *shell, int argc, char **argv);
+
 // --- Available commands list ---
-static const char *available_commands[] = {"help", "clear", "history", "version"};
+static const char *available_commands[] = {"help", "clear", "history", "version", "isrprof", "baud", "uartstat"};
 static const size_t num_available_commands = sizeof(available_commands) / sizeof(available_commands[0]);
 
 
@@ -118,6 +164,12 @@ void cli_parser_execute(void *shell_parent, char *command_line) {
         cli_cmd_history(shell, argc, argv);
     } else if (strcmp(argv[0], "version") == 0) {
         cli_cmd_version(shell, argc, argv);
+    } else if (strcmp(argv[0], "isrprof") == 0) {
+        cli_cmd_isrprof(shell, argc, argv);
+    } else if (strcmp(argv[0], "baud") == 0) {
+        cli_cmd_baud(shell, argc, argv);
+    } else if (strcmp(argv[0], "uartstat") == 0) {
+        cli_cmd_uartstat(shell, argc, argv);
     } else {
         shell_printf(shell, "Unknown command or argument: %s" NEWLINE_SEQ, argv[0]);
         shell_printf(shell, "Type 'help' for available commands." NEWLINE_SEQ NEWLINE_SEQ);
@@ -130,15 +182,21 @@ static void cli_cmd_help(shell_t *shell, int argc, char **argv) {
         return;
     }
     if (argc == 1) {
-        shell_printf(shell, help_general_text);
+        CLI_SEND_TEXT(shell, help_general_text);
     } else {
         const char *cmd = argv[1];
         if (strcmp(cmd, "clear") == 0) {
-            shell_printf(shell, help_clear_text);
+            CLI_SEND_TEXT(shell, help_clear_text);
         } else if (strcmp(cmd, "history") == 0) {
-            shell_printf(shell, help_history_text);
+            CLI_SEND_TEXT(shell, help_history_text);
         } else if (strcmp(cmd, "version") == 0) {
-            shell_printf(shell, help_version_text);
+            CLI_SEND_TEXT(shell, help_version_text);
+        } else if (strcmp(cmd, "isrprof") == 0) {
+            CLI_SEND_TEXT(shell, help_isrprof_text);
+        } else if (strcmp(cmd, "baud") == 0) {
+            CLI_SEND_TEXT(shell, help_baud_text);
+        } else if (strcmp(cmd, "uartstat") == 0) {
+            CLI_SEND_TEXT(shell, help_uartstat_text);
         } else if (strcmp(cmd, "help") == 0) {
             // Ignore on purpose
         } else {
@@ -154,7 +212,7 @@ static void cli_cmd_clear(shell_t *shell, int argc, char **argv) {
     }
     if (argc == 2) {
         if (strcmp(argv[1], "help") == 0) {
-            shell_printf(shell, help_clear_text);
+            CLI_SEND_TEXT(shell, help_clear_text);
         } else {
             shell_printf(shell, "clear:  " UNKNOWN_ARGUMENT_SEQ, argv[1]);
         }
@@ -170,7 +228,7 @@ static void cli_cmd_history(shell_t *shell, int argc, char **argv) {
     }
     if (argc == 2) {
         if (strcmp(argv[1], "help") == 0) {
-            shell_printf(shell, help_history_text);
+            CLI_SEND_TEXT(shell, help_history_text);
         } else {
             shell_printf(shell, "history: " UNKNOWN_ARGUMENT_SEQ, argv[1]);
         }
@@ -186,7 +244,7 @@ static void cli_cmd_version(shell_t *shell, int argc, char **argv) {
     }
     if (argc == 2) {
         if (strcmp(argv[1], "help") == 0) {
-            shell_printf(shell, help_version_text);
+            CLI_SEND_TEXT(shell, help_version_text);
         } else {
             shell_printf(shell, "version: " UNKNOWN_ARGUMENT_SEQ, argv[1]);
         }
@@ -195,6 +253,179 @@ static void cli_cmd_version(shell_t *shell, int argc, char **argv) {
     shell_printf(shell, "Version: %d.%d.%s" NEWLINE_SEQ NEWLINE_SEQ, TARGET_VER_MAJOR, TARGET_VER_MINOR, TARGET_VER_DATE);
 }
 
+static void cli_cmd_isrprof(shell_t *shell, int argc, char **argv) {
+    if (argc > 2) {
+        shell_printf(shell, TOO_MANY_ARGUMENTS_TEXT NEWLINE_SEQ);
+        return;
+    }
+
+    uart_driver_t *driver = shell_get_driver_instance(shell);
+    if (driver == NULL) {
+        shell_printf(shell, "isrprof: the shell is not on a UART" NEWLINE_SEQ NEWLINE_SEQ);
+        return;
+    }
+    if (argc == 2) {
+        if (strcmp(argv[1], "help") == 0) {
+            CLI_SEND_TEXT(shell, help_isrprof_text);
+        } else if (strcmp(argv[1], "reset") == 0) {
+            (void)uart_driver_reset_profile(driver);
+        } else {
+            shell_printf(shell, "isrprof: " UNKNOWN_ARGUMENT_SEQ, argv[1]);
+        }
+        return;
+    }
+
+    uart_driver_profile_t profile;
+    if (!uart_driver_get_profile(driver, &profile)) {
+        return;
+    }
+
+    shell_printf(shell, "Backend:     %s" NEWLINE_SEQ,
+                 (driver->backend == UART_DRIVER_BACKEND_REGISTER) ? "register" : "HAL");
+    // Tenths of a cycle, printed without pulling in floating-point printf
+    unsigned long per_irq = (profile.irqs > 0U) ? (unsigned long)((profile.cycles * 10U) / profile.irqs) : 0UL;
+
+    shell_printf(shell, "Interrupts:  %lu" NEWLINE_SEQ, (unsigned long)profile.irqs);
+    shell_printf(shell, "Cycles/irq:  %lu.%lu (max %lu)" NEWLINE_SEQ, per_irq / 10UL, per_irq % 10UL,
+                 (unsigned long)profile.max_cycles);
+#if UART_DRIVER_PROFILE
+    unsigned long per_byte = (profile.bytes > 0U) ? (unsigned long)((profile.cycles * 10U) / profile.bytes) : 0UL;
+
+    shell_printf(shell, "Bytes:       %lu" NEWLINE_SEQ, (unsigned long)profile.bytes);
+    shell_printf(shell, "Cycles/byte: %lu.%lu" NEWLINE_SEQ NEWLINE_SEQ, per_byte / 10UL, per_byte % 10UL);
+#else
+    shell_printf(shell, "Cycles/byte: n/a, needs UART_DRIVER_PROFILE=1" NEWLINE_SEQ NEWLINE_SEQ);
+#endif
+}
+
+static void cli_cmd_baud(shell_t *shell, int argc, char **argv) {
+    if (argc > 3) {
+        shell_printf(shell, TOO_MANY_ARGUMENTS_TEXT NEWLINE_SEQ);
+        return;
+    }
+
+    uart_driver_t *driver = shell_get_driver_instance(shell);
+    if (driver == NULL) {
+        shell_printf(shell, "baud: the shell is not on a UART" NEWLINE_SEQ NEWLINE_SEQ);
+        return;
+    }
+    if (argc == 1) {
+        shell_printf(shell, "Baud rate: %lu (%ux oversampling)" NEWLINE_SEQ NEWLINE_SEQ,
+                     (unsigned long)driver->huart->Init.BaudRate,
+                     (driver->huart->Init.OverSampling == UART_OVERSAMPLING_8) ? 8U : 16U);
+        return;
+    }
+
+    if ((strcmp(argv[1], "help") == 0) || (strcmp(argv[1], "ok") == 0)) {
+        if (argc == 3) {
+            shell_printf(shell, "baud: " UNKNOWN_ARGUMENT_SEQ, argv[2]);
+        } else if (strcmp(argv[1], "help") == 0) {
+            CLI_SEND_TEXT(shell, help_baud_text);
+        } else if (shell_confirm_baud(shell)) {
+            shell_printf(shell, "baud: keeping %lu" NEWLINE_SEQ NEWLINE_SEQ, (unsigned long)driver->huart->Init.BaudRate);
+        } else {
+            shell_printf(shell, "baud: nothing to confirm" NEWLINE_SEQ NEWLINE_SEQ);
+        }
+        return;
+    }
+
+    bool confirm = false;
+    if (argc == 3) {
+        if (strcmp(argv[2], "try") != 0) {
+            shell_printf(shell, "baud: " UNKNOWN_ARGUMENT_SEQ, argv[2]);
+            return;
+        }
+        confirm = true;
+    }
+
+    char *end;
+    uint32_t rate = (uint32_t)strtoul(argv[1], &end, 10);
+    if ((*end != '\0') || (rate == 0U)) {
+        shell_printf(shell, "baud: " UNKNOWN_ARGUMENT_SEQ, argv[1]);
+        return;
+    }
+
+    uint32_t actual;
+    uint32_t oversampling;
+    if (!uart_driver_check_baud(driver, rate, &actual, &oversampling)) {
+        if (actual == 0U) {
+            shell_printf(shell, "baud: %lu out of range" NEWLINE_SEQ NEWLINE_SEQ, (unsigned long)rate);
+        } else {
+            shell_printf(shell, "baud: %lu not reachable, closest is %lu" NEWLINE_SEQ NEWLINE_SEQ,
+                         (unsigned long)rate, (unsigned long)actual);
+        }
+        return;
+    }
+
+    shell_printf(shell, "baud: switching to %lu (actual %lu, %ux oversampling)" NEWLINE_SEQ, (unsigned long)rate,
+                 (unsigned long)actual, (oversampling == UART_OVERSAMPLING_8) ? 8U : 16U);
+    if (confirm) {
+        shell_printf(shell, "baud: enter 'baud ok' within %lu s or it reverts" NEWLINE_SEQ,
+                     (unsigned long)(SHELL_BAUD_CONFIRM_MS / 1000U));
+    }
+    shell_printf(shell, NEWLINE_SEQ);
+
+    if (!shell_set_baud(shell, rate, confirm)) {
+        shell_printf(shell, "baud: switch failed" NEWLINE_SEQ NEWLINE_SEQ);
+    }
+}
+
+static void cli_cmd_uartstat(shell_t *shell, int argc, char **argv) {
+    if (argc > 2) {
+        shell_printf(shell, TOO_MANY_ARGUMENTS_TEXT NEWLINE_SEQ);
+        return;
+    }
+
+    uart_driver_t *driver = shell_get_driver_instance(shell);
+    if (driver == NULL) {
+        shell_printf(shell, "uartstat: the shell is not on a UART" NEWLINE_SEQ NEWLINE_SEQ);
+        return;
+    }
+    if (argc == 2) {
+        if (strcmp(argv[1], "help") == 0) {
+            CLI_SEND_TEXT(shell, help_uartstat_text);
+        } else if (strcmp(argv[1], "reset") == 0) {
+            (void)uart_driver_reset_stats(driver);
+            (void)uart_driver_reset_errors(driver);
+            (void)uart_driver_reset_profile(driver);
+        } else {
+            shell_printf(shell, "uartstat: " UNKNOWN_ARGUMENT_SEQ, argv[1]);
+        }
+        return;
+    }
+
+    uart_driver_stats_t stats;
+    uart_driver_errors_t errors;
+    uart_driver_flow_stats_t flow;
+    uart_driver_profile_t profile;
+    if (!uart_driver_get_stats(driver, &stats) || !uart_driver_get_errors(driver, &errors) ||
+        !uart_driver_get_flow_stats(driver, &flow) || !uart_driver_get_profile(driver, &profile)) {
+        return;
+    }
+
+    // Tenths of a percent, printed without pulling in floating-point printf
+    unsigned long busy = (stats.elapsed_ms > 0U) ? (unsigned long)(((uint64_t)stats.tx_busy_ms * 1000U) / stats.elapsed_ms) : 0UL;
+
+    shell_printf(shell, "Elapsed:    %lu ms at %lu baud" NEWLINE_SEQ, (unsigned long)stats.elapsed_ms,
+                 (unsigned long)driver->huart->Init.BaudRate);
+    shell_printf(shell, "RX:         %lu bytes, ring high water %lu/%u, dropped %lu" NEWLINE_SEQ,
+                 (unsigned long)stats.rx_bytes, (unsigned long)stats.rx_high_water, (unsigned)UART_DRIVER_MAX_RX_BUFFER,
+                 (unsigned long)stats.rx_dropped);
+    shell_printf(shell, "TX:         %lu bytes in %lu transfers, ring high water %lu/%u, dropped %lu" NEWLINE_SEQ,
+                 (unsigned long)stats.tx_bytes, (unsigned long)stats.tx_transfers, (unsigned long)stats.tx_high_water,
+                 (unsigned)UART_DRIVER_MAX_TX_BUFFER, (unsigned long)stats.tx_dropped);
+    shell_printf(shell, "TX busy:    %lu ms (%lu.%lu%%)" NEWLINE_SEQ, (unsigned long)stats.tx_busy_ms,
+                 busy / 10UL, busy % 10UL);
+    unsigned long per_irq = (profile.irqs > 0U) ? (unsigned long)((profile.cycles * 10U) / profile.irqs) : 0UL;
+    shell_printf(shell, "Interrupts: %lu, %lu.%lu cycles avg, %lu max" NEWLINE_SEQ, (unsigned long)profile.irqs,
+                 per_irq / 10UL, per_irq % 10UL, (unsigned long)profile.max_cycles);
+    shell_printf(shell, "Errors:     overrun %lu, framing %lu, noise %lu, parity %lu, DMA %lu, RX restarts %lu" NEWLINE_SEQ,
+                 (unsigned long)errors.overrun, (unsigned long)errors.framing, (unsigned long)errors.noise,
+                 (unsigned long)errors.parity, (unsigned long)errors.dma, (unsigned long)errors.rx_restarts);
+    shell_printf(shell, "Flow:       peer throttled %lu, paused by peer %lu" NEWLINE_SEQ NEWLINE_SEQ,
+                 (unsigned long)flow.rx_throttled, (unsigned long)flow.tx_paused);
+}
+
 size_t cli_parser_get_commands(const char ***commands) {
     if (commands != NULL) {
         *commands = available_commands;
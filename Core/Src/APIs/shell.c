@@ -2,8 +2,9 @@
  * @file shell.c
  * @brief UART shell implementation for STM32 microcontrollers.
  *
- * This file provides a simple command-line shell over UART, supporting
- * line editing, command history, and basic built-in commands.
+ * This file provides a simple command-line shell over a byte transport
+ * (the UART by default), supporting line editing, command history, and
+ * basic built-in commands.
  *
  * @author Santiago Rincon
  * @date 2025
@@ -19,6 +20,15 @@
 #include "target_ver.h"
 #include "cli_parser.h"
 
+/**
+ * @brief Sends bytes, waiting up to SHELL_TX_TIMEOUT_MS for transport room.
+ * @param shell Pointer to the shell instance.
+ * @param data Bytes to send.
+ * @param length Number of bytes to send.
+ * @return Number of bytes queued.
+ */
+static size_t shell_send(shell_t *shell, const uint8_t *data, size_t length);
+
 /**
  * @brief Prints the startup banner with project information.
  * @param shell Pointer to the shell instance.
@@ -110,6 +120,31 @@ static void handle_cursor_down(shell_t *shell);
  */
 static void handle_tab_completion(shell_t *shell);
 
+/**
+ * @brief Feeds one received byte through the escape-sequence state machine.
+ * @param shell Pointer to the shell instance.
+ * @param received_byte Byte received from UART.
+ */
+static void shell_process_byte(shell_t *shell, uint8_t received_byte);
+
+/**
+ * @brief Takes a complete received line in one bulk read.
+ *
+ * Used when a line terminator is already in the RX ring and no line is in
+ * progress. A line made only of printable characters is echoed and executed
+ * directly; anything else is replayed through shell_process_byte().
+ * @param shell Pointer to the shell instance.
+ * @param line_length Number of bytes before the '\r' terminator.
+ * @return true if the line was consumed, false if the byte-wise path must handle it.
+ */
+static bool shell_process_line(shell_t *shell, size_t line_length);
+
+/**
+ * @brief Processes all input waiting on the transport.
+ * @param shell Pointer to the shell instance.
+ */
+static void shell_process_input(shell_t *shell);
+
 /**
  * @brief Main shell processing loop.
  * Reads UART input and processes shell logic.
@@ -123,8 +158,9 @@ void shell_task(shell_t *shell);
  * @param shell Pointer to the shell instance.
  * @param format Printf-style format string.
  * @param ... Variable arguments.
+ * @return Number of bytes queued.
  */
-void shell_printf(shell_t *shell, const char *format, ...);
+size_t shell_printf(shell_t *shell, const char *format, ...);
 
 /**
  * @brief Initializes the shell instance.
@@ -134,6 +170,17 @@ void shell_printf(shell_t *shell, const char *format, ...);
  */
 bool shell_init(shell_t *shell, UART_HandleTypeDef *huart);
 
+/**
+ * @brief Starts a statically initialized shell instance.
+ * @param shell Pointer to the shell instance defined with SHELL_INITIALIZER().
+ * @return true if the shell was started, false otherwise.
+ */
+bool shell_start(shell_t *shell);
+
+static size_t shell_send(shell_t *shell, const uint8_t *data, size_t length) {
+    return shell_transport_send(&shell->transport, data, length, SHELL_TX_TIMEOUT_MS);
+}
+
 static void shell_print_startup_message(shell_t *shell) {
     if (shell == NULL) {
         return;
@@ -184,17 +231,17 @@ static void shell_clear_line(shell_t *shell) {
 
     // Move cursor to beginning of input
     for (size_t line_position = 0; line_position < shell->rx.cursor_pos; line_position++) {
-        uart_driver_send(&shell->driver, (uint8_t *)"\b", 1);
+        shell_send(shell, (uint8_t *)"\b", 1);
     }
 
     // Clear the line
     for (size_t line_position = 0; line_position < shell->rx.length; line_position++) {
-        uart_driver_send(&shell->driver, (uint8_t *)" ", 1);
+        shell_send(shell, (uint8_t *)" ", 1);
     }
 
     // Move cursor back to beginning
     for (size_t line_position = 0; line_position < shell->rx.length; line_position++) {
-        uart_driver_send(&shell->driver, (uint8_t *)"\b", 1);
+        shell_send(shell, (uint8_t *)"\b", 1);
     }
 }
 
@@ -204,12 +251,12 @@ static void shell_redraw_line(shell_t *shell) {
     }
 
     // Print the buffer
-    uart_driver_send(&shell->driver, shell->rx.buffer, shell->rx.length);
+    shell_send(shell, shell->rx.buffer, shell->rx.length);
 
     // Position cursor correctly
     size_t chars_to_move_back = shell->rx.length - shell->rx.cursor_pos;
     for (size_t line_position = 0; line_position < chars_to_move_back; line_position++) {
-        uart_driver_send(&shell->driver, (uint8_t *)"\b", 1);
+        shell_send(shell, (uint8_t *)"\b", 1);
     }
 }
 
@@ -261,16 +308,16 @@ static void handle_printable_character(shell_t *shell, uint8_t received_char) {
     // Echo the character and handle display update
     if (shell->rx.cursor_pos == (shell->rx.length - 1)) {
         // Appending at the end - just echo the character
-        uart_driver_send(&shell->driver, &received_char, 1);
+        shell_send(shell, &received_char, 1);
     } else {
         // Inserted in the middle - redraw from cursor position to end
         size_t chars_from_cursor_to_end = (shell->rx.length - shell->rx.cursor_pos);
-        uart_driver_send(&shell->driver, &shell->rx.buffer[shell->rx.cursor_pos], chars_from_cursor_to_end);
+        shell_send(shell, &shell->rx.buffer[shell->rx.cursor_pos], chars_from_cursor_to_end);
 
         // Move cursor back to correct position (after the inserted character)
         size_t cursor_backtrack_count = (chars_from_cursor_to_end - 1);
         for (size_t backtrack_idx = 0; backtrack_idx < cursor_backtrack_count; backtrack_idx++) {
-            uart_driver_send(&shell->driver, (uint8_t *)"\b", 1);
+            shell_send(shell, (uint8_t *)"\b", 1);
         }
     }
 
@@ -307,15 +354,15 @@ static void handle_backspace(shell_t *shell) {
     shell->rx.buffer[shell->rx.length] = '\0';
 
     // Update display
-    uart_driver_send(&shell->driver, (uint8_t *)"\b", 1);
+    shell_send(shell, (uint8_t *)"\b", 1);
     size_t chars_from_cursor_to_end = (shell->rx.length - shell->rx.cursor_pos);
-    uart_driver_send(&shell->driver, &shell->rx.buffer[shell->rx.cursor_pos], chars_from_cursor_to_end);
-    uart_driver_send(&shell->driver, (uint8_t *)" \b", 2);
+    shell_send(shell, &shell->rx.buffer[shell->rx.cursor_pos], chars_from_cursor_to_end);
+    shell_send(shell, (uint8_t *)" \b", 2);
 
     // Move cursor back to correct position
     size_t cursor_backtrack_count = (shell->rx.length - shell->rx.cursor_pos);
     for (size_t backtrack_idx = 0; backtrack_idx < cursor_backtrack_count; backtrack_idx++) {
-        uart_driver_send(&shell->driver, (uint8_t *)"\b", 1);
+        shell_send(shell, (uint8_t *)"\b", 1);
     }
 }
 
@@ -325,7 +372,7 @@ static void handle_cursor_left(shell_t *shell) {
     }
 
     shell->rx.cursor_pos--;
-    uart_driver_send(&shell->driver, (uint8_t *)"\b", 1);
+    shell_send(shell, (uint8_t *)"\b", 1);
 }
 
 static void handle_cursor_right(shell_t *shell) {
@@ -333,7 +380,7 @@ static void handle_cursor_right(shell_t *shell) {
         return;
     }
 
-    uart_driver_send(&shell->driver, &shell->rx.buffer[shell->rx.cursor_pos], 1);
+    shell_send(shell, &shell->rx.buffer[shell->rx.cursor_pos], 1);
     shell->rx.cursor_pos++;
 }
 
@@ -438,89 +485,211 @@ static void handle_tab_completion(shell_t *shell) {
     }
 }
 
-void shell_task(shell_t *shell) {
-    if (shell == NULL) return;
+static void shell_process_byte(shell_t *shell, uint8_t received_byte) {
+    // Handle buffer overflow
+    if ((shell->rx.length >= (SHELL_MAX_LENGTH - 1)) && (received_byte != '\r') && (received_byte != 127)) {
+        shell_printf(shell, NEWLINE_SEQ "Error: Command too long!" NEWLINE_SEQ);
+        shell->rx.length = 0;
+        shell->rx.cursor_pos = 0;
+        shell_send_prompt(shell);
+        return;
+    }
 
-    static enum {
-        STATE_NORMAL,
-        STATE_ESC,
-        STATE_CSI
-    } parsing_state = STATE_NORMAL;
+    switch (shell->rx.parse_state) {
+        case SHELL_PARSE_NORMAL:
+            if (received_byte == 27) {
+                shell->rx.parse_state = SHELL_PARSE_ESC;
+            } else if (received_byte == '\r') {
+                handle_carriage_return(shell);
+            } else if ((received_byte == 127) || (received_byte == 8)) {
+                handle_backspace(shell);
+            } else if (received_byte == '\t') {
+                handle_tab_completion(shell);
+            } else if ((received_byte >= 32) && (received_byte <= 126)) {
+                handle_printable_character(shell, received_byte);
+            }
+            break;
+
+        case SHELL_PARSE_ESC:
+            if (received_byte == '[') {
+                shell->rx.parse_state = SHELL_PARSE_CSI;
+            } else {
+                shell->rx.parse_state = SHELL_PARSE_NORMAL;
+            }
+            break;
+
+        case SHELL_PARSE_CSI:
+            switch (received_byte) {
+                case 'A':
+                    handle_cursor_up(shell);
+                    break;
+                case 'B':
+                    handle_cursor_down(shell);
+                    break;
+                case 'C':
+                    handle_cursor_right(shell);
+                    break;
+                case 'D':
+                    handle_cursor_left(shell);
+                    break;
+                default:
+                    break;
+            }
+            shell->rx.parse_state = SHELL_PARSE_NORMAL;
+            break;
+    }
+}
 
-    uint8_t received_byte;
+static bool shell_process_line(shell_t *shell, size_t line_length) {
+    uint8_t line[SHELL_MAX_LENGTH];
 
-    while (uart_driver_get_byte(&shell->driver, &received_byte)) {
+    // Only a fresh line with room for the terminator qualifies
+    if ((shell->rx.length != 0U) || (shell->rx.parse_state != SHELL_PARSE_NORMAL) ||
+        (line_length >= (SHELL_MAX_LENGTH - 1))) {
+        return false;
+    }
+
+    size_t received_count = shell_transport_recv(&shell->transport, line, line_length + 1U);
+
+    // The '\n' of a previous "\r\n" terminator is ignored by the byte-wise path too
+    size_t line_start = 0U;
+    while ((line_start < line_length) && (line[line_start] == '\n')) {
+        line_start++;
+    }
+
+    bool printable = (received_count == (line_length + 1U));
+    for (size_t byte_idx = line_start; printable && (byte_idx < line_length); byte_idx++) {
+        printable = ((line[byte_idx] >= 32) && (line[byte_idx] <= 126));
+    }
+
+    if (!printable) {
+        // Editing keys or escape sequences inside the line: replay it byte by byte
+        for (size_t byte_idx = 0; byte_idx < received_count; byte_idx++) {
+            shell_process_byte(shell, line[byte_idx]);
+        }
+        return true;
+    }
+
+    line_length -= line_start;
+    memcpy(shell->rx.buffer, &line[line_start], line_length);
+    shell->rx.length = line_length;
+    shell->rx.cursor_pos = line_length;
+    shell->rx.buffer[line_length] = '\0';
+
+    // Same echo as typing the line, in one send
+    shell_send(shell, shell->rx.buffer, line_length);
+    handle_carriage_return(shell);
+    return true;
+}
+
+static void shell_baud_task(shell_t *shell) {
+    uint32_t revert_rate = shell->baud.revert_rate;
 
-        // Handle buffer overflow
-        if ((shell->rx.length >= (SHELL_MAX_LENGTH - 1)) && (received_byte != '\r') && (received_byte != 127)) {
-            shell_printf(shell, NEWLINE_SEQ "Error: Command too long!" NEWLINE_SEQ);
-            shell->rx.length = 0;
-            shell->rx.cursor_pos = 0;
-            shell_send_prompt(shell);
-            continue;
+    if ((revert_rate == 0U) || ((HAL_GetTick() - shell->baud.start_tick) < SHELL_BAUD_CONFIRM_MS)) {
+        return;
+    }
+
+    shell->baud.revert_rate = 0U;
+    if (uart_driver_reconfigure(shell_get_driver_instance(shell), revert_rate)) {
+        shell_printf(shell, NEWLINE_SEQ "baud: not confirmed, back to %lu" NEWLINE_SEQ, (unsigned long)revert_rate);
+        shell_send_prompt(shell);
+        shell_redraw_line(shell);
+    }
+}
+
+static void shell_process_input(shell_t *shell) {
+    uint8_t received_bytes[SHELL_RX_CHUNK_SIZE];
+    size_t received_count;
+
+    for (;;) {
+        size_t chunk_size = sizeof(received_bytes);
+        size_t line_length;
+
+        if (shell_transport_find(&shell->transport, '\r', &line_length)) {
+            if (shell_process_line(shell, line_length)) {
+                continue;
+            }
+            // Stop the chunk at the terminator so the next line can take the fast path
+            if (line_length < chunk_size) {
+                chunk_size = line_length + 1U;
+            }
         }
 
-        switch (parsing_state) {
-            case STATE_NORMAL:
-                if (received_byte == 27) {
-                    parsing_state = STATE_ESC;
-                } else if (received_byte == '\r') {
-                    handle_carriage_return(shell);
-                } else if ((received_byte == 127) || (received_byte == 8)) {
-                    handle_backspace(shell);
-                } else if (received_byte == '\t') {
-                    handle_tab_completion(shell);
-                } else if ((received_byte >= 32) && (received_byte <= 126)) {
-                    handle_printable_character(shell, received_byte);
-                }
-                break;
-
-            case STATE_ESC:
-                if (received_byte == '[') {
-                    parsing_state = STATE_CSI;
-                } else {
-                    parsing_state = STATE_NORMAL;
-                }
-                break;
-
-            case STATE_CSI:
-                switch (received_byte) {
-                    case 'A':
-                        handle_cursor_up(shell);
-                        break;
-                    case 'B':
-                        handle_cursor_down(shell);
-                        break;
-                    case 'C':
-                        handle_cursor_right(shell);
-                        break;
-                    case 'D':
-                        handle_cursor_left(shell);
-                        break;
-                    default:
-                        break;
-                }
-                parsing_state = STATE_NORMAL;
-                break;
+        received_count = shell_transport_recv(&shell->transport, received_bytes, chunk_size);
+        if (received_count == 0U) {
+            break;
         }
+
+        for (size_t byte_idx = 0; byte_idx < received_count; byte_idx++) {
+            shell_process_byte(shell, received_bytes[byte_idx]);
+        }
+    }
+}
+
+void shell_task(shell_t *shell) {
+    if (shell == NULL) return;
+
+    shell_baud_task(shell);
+
+    if (shell_transport_ready(&shell->transport) > 0U) {
+        shell_process_input(shell);
     }
+
+    // Everything this pass wrote, plus output printed since the last one, goes out together
+    shell_transport_tx_kick(&shell->transport);
 }
 
-void shell_printf(shell_t *shell, const char *format, ...) {
+size_t shell_printf(shell_t *shell, const char *format, ...) {
     if ((shell == NULL) || (format == NULL)) {
-        return;
+        return 0U;
     }
 
-    char buffer[SHELL_MAX_LENGTH];
     va_list args;
 
+    // Format straight into the transport when the output fits its contiguous free region;
+    // a multi-producer UART TX ring offers no region and takes the copy below
+    uint8_t *region;
+    size_t region_size = shell_transport_tx_acquire(&shell->transport, &region);
+    if (region_size > 0U) {
+        va_start(args, format);
+        int len = vsnprintf((char *)region, region_size, format, args);
+        va_end(args);
+
+        if ((len >= 0) && ((size_t)len < region_size)) {
+            (void) shell_transport_tx_commit(&shell->transport, (size_t)len);
+            return (size_t)len;
+        }
+    }
+
+    char buffer[SHELL_MAX_LENGTH];
+
     va_start(args, format);
     int len = vsnprintf(buffer, sizeof(buffer), format, args);
     va_end(args);
 
-    if ((len > 0) && (len < (int)sizeof(buffer))) {
-        uart_driver_send(&shell->driver, (uint8_t *)buffer, (size_t)len);
+    if ((len <= 0) || (len >= (int)sizeof(buffer))) {
+        return 0U;
+    }
+
+    // Waits for space rather than cutting the output; from an ISR it queues what fits
+    return shell_send(shell, (uint8_t *)buffer, (size_t)len);
+}
+
+size_t shell_send_bytes(shell_t *shell, uint8_t *data, size_t len) {
+    if ((shell == NULL) || (data == NULL)) {
+        return 0U;
     }
+    return shell_send(shell, data, len);
+}
+
+size_t shell_send_static(shell_t *shell, const uint8_t *data, size_t len) {
+    if ((shell == NULL) || (data == NULL)) {
+        return 0U;
+    }
+    if ((len > 0U) && shell_transport_send_ref(&shell->transport, data, len)) {
+        return len;
+    }
+    return shell_send(shell, data, len);
 }
 
 void shell_clear_screen(shell_t *shell) {
@@ -557,9 +726,77 @@ bool shell_init(shell_t *shell, UART_HandleTypeDef *huart) {
     if (!uart_driver_init(&shell->driver, huart)) {
         return false;
     }
+    shell->transport = (shell_transport_t) SHELL_TRANSPORT_UART_INITIALIZER(&shell->driver);
+    (void) uart_driver_set_tx_deferred(&shell->driver, SHELL_TX_WRITE_COMBINING != 0);
+
+    shell_print_startup_message(shell);
+    shell_send_prompt(shell);
+    shell_transport_tx_kick(&shell->transport);
+
+    return true;
+}
+
+bool shell_init_transport(shell_t *shell, const shell_transport_t *transport) {
+    if ((shell == NULL) || (transport == NULL) || (transport->ops == NULL)) {
+        return false;
+    }
+
+    memset(shell, 0, sizeof(shell_t));
+    shell->transport = *transport;
+
+    shell_print_startup_message(shell);
+    shell_send_prompt(shell);
+    shell_transport_tx_kick(&shell->transport);
+
+    return true;
+}
+
+bool shell_set_baud(shell_t *shell, uint32_t baud_rate, bool confirm) {
+    if ((shell == NULL) || (shell_get_driver_instance(shell) == NULL)) {
+        return false;
+    }
+
+    uint32_t old_rate = shell->driver.huart->Init.BaudRate;
+    if (!uart_driver_reconfigure(&shell->driver, baud_rate)) {
+        return false;
+    }
+
+    shell->baud.revert_rate = confirm ? old_rate : 0U;
+    shell->baud.start_tick = HAL_GetTick();
+    return true;
+}
+
+bool shell_confirm_baud(shell_t *shell) {
+    if ((shell == NULL) || (shell->baud.revert_rate == 0U)) {
+        return false;
+    }
+
+    shell->baud.revert_rate = 0U;
+    return true;
+}
+
+bool shell_flush(shell_t *shell, uint32_t timeout_ms) {
+    if (shell == NULL) {
+        return false;
+    }
+
+    return shell_transport_flush(&shell->transport, timeout_ms);
+}
+
+bool shell_start(shell_t *shell) {
+    if ((shell == NULL) || (shell->transport.ops == NULL)) {
+        return false;
+    }
+    if (shell_get_driver_instance(shell) != NULL) {
+        if (!uart_driver_start(&shell->driver)) {
+            return false;
+        }
+        (void) uart_driver_set_tx_deferred(&shell->driver, SHELL_TX_WRITE_COMBINING != 0);
+    }
 
     shell_print_startup_message(shell);
     shell_send_prompt(shell);
+    shell_transport_tx_kick(&shell->transport);
 
     return true;
 }
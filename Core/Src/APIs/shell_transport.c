@@ -0,0 +1,123 @@
+/**
+ * @file shell_transport.c
+ * @brief UART and loopback transports for the shell.
+ *
+ * @author Santiago Rincon
+ * @date 2026
+ */
+
+#include "shell_transport.h"
+#include "uart_driver.h"
+
+// --- UART transport ---
+
+static size_t uart_transport_send(void *context, const uint8_t *data, size_t length, uint32_t timeout_ms) {
+    return uart_driver_send_timeout((uart_driver_t *)context, (uint8_t *)data, length, timeout_ms);
+}
+
+static size_t uart_transport_recv(void *context, uint8_t *buffer, size_t length) {
+    return uart_driver_get_bytes((uart_driver_t *)context, buffer, length);
+}
+
+static bool uart_transport_flush(void *context, uint32_t timeout_ms) {
+    return uart_driver_flush((uart_driver_t *)context, timeout_ms);
+}
+
+static size_t uart_transport_ready(void *context) {
+    return uart_driver_rx_available((uart_driver_t *)context);
+}
+
+static bool uart_transport_find(void *context, uint8_t byte, size_t *position) {
+    return uart_driver_find_byte((uart_driver_t *)context, byte, position);
+}
+
+static size_t uart_transport_tx_acquire(void *context, uint8_t **region) {
+    return uart_driver_tx_acquire((uart_driver_t *)context, region);
+}
+
+static bool uart_transport_tx_commit(void *context, size_t length) {
+    return uart_driver_tx_commit((uart_driver_t *)context, length);
+}
+
+static void uart_transport_tx_kick(void *context) {
+    uart_driver_tx_kick((uart_driver_t *)context);
+}
+
+static bool uart_transport_send_ref(void *context, const uint8_t *data, size_t length) {
+    return uart_driver_send_ref((uart_driver_t *)context, data, length);
+}
+
+const shell_transport_ops_t shell_transport_uart_ops = {
+    .send = uart_transport_send,
+    .recv = uart_transport_recv,
+    .flush = uart_transport_flush,
+    .ready = uart_transport_ready,
+    .find = uart_transport_find,
+    .tx_acquire = uart_transport_tx_acquire,
+    .tx_commit = uart_transport_tx_commit,
+    .tx_kick = uart_transport_tx_kick,
+    .send_ref = uart_transport_send_ref,
+};
+
+// --- Loopback transport ---
+
+static size_t loopback_send(void *context, const uint8_t *data, size_t length, uint32_t timeout_ms) {
+    (void) timeout_ms;  // Nothing drains the output while the shell waits, so it never does
+    return ring_buffer_write(&((shell_loopback_t *)context)->output, data, length);
+}
+
+static size_t loopback_recv(void *context, uint8_t *buffer, size_t length) {
+    return ring_buffer_read(&((shell_loopback_t *)context)->input, buffer, length);
+}
+
+static bool loopback_flush(void *context, uint32_t timeout_ms) {
+    (void) context;
+    (void) timeout_ms;
+    return true;
+}
+
+static size_t loopback_ready(void *context) {
+    return ring_buffer_get_count(&((shell_loopback_t *)context)->input);
+}
+
+static bool loopback_find(void *context, uint8_t byte, size_t *position) {
+    return ring_buffer_find(&((shell_loopback_t *)context)->input, byte, position);
+}
+
+static size_t loopback_tx_acquire(void *context, uint8_t **region) {
+    return ring_buffer_write_acquire(&((shell_loopback_t *)context)->output, region);
+}
+
+static bool loopback_tx_commit(void *context, size_t length) {
+    return ring_buffer_write_commit(&((shell_loopback_t *)context)->output, length);
+}
+
+const shell_transport_ops_t shell_transport_loopback_ops = {
+    .send = loopback_send,
+    .recv = loopback_recv,
+    .flush = loopback_flush,
+    .ready = loopback_ready,
+    .find = loopback_find,
+    .tx_acquire = loopback_tx_acquire,
+    .tx_commit = loopback_tx_commit,
+};
+
+bool shell_loopback_init(shell_loopback_t *loopback, uint8_t *input, size_t input_size,
+                         uint8_t *output, size_t output_size) {
+    if (loopback == NULL) {
+        return false;
+    }
+
+    return ring_buffer_init(&loopback->input, input, input_size) &&
+           ring_buffer_init(&loopback->output, output, output_size);
+}
+
+bool shell_transport_bind_loopback(shell_transport_t *transport, shell_loopback_t *loopback) {
+    if ((transport == NULL) || (loopback == NULL)) {
+        return false;
+    }
+
+    transport->ops = &shell_transport_loopback_ops;
+    transport->context = loopback;
+    return true;
+}
@@ -10,109 +10,1357 @@
 
 #include "uart_driver.h"
 
+#if UART_DRIVER_PROFILE
+#define UART_DRIVER_PROFILE_BYTES(uart_driver, count) ((uart_driver)->profile.bytes += (uint32_t)(count))
+#else
+#define UART_DRIVER_PROFILE_BYTES(uart_driver, count) ((void) 0)
+#endif
+
+/** Count bytes received for uart_driver_get_stats() and the profile */
+#define UART_DRIVER_RX_BYTES(uart_driver, count) \
+    ((uart_driver)->rx_count += (uint32_t)(count), UART_DRIVER_PROFILE_BYTES(uart_driver, count))
+
+/** Count bytes sent for uart_driver_get_stats() and the profile */
+#define UART_DRIVER_TX_BYTES(uart_driver, count) \
+    ((uart_driver)->tx_count += (uint32_t)(count), UART_DRIVER_PROFILE_BYTES(uart_driver, count))
+
+/** Registry slot of a USART instance, see UART_DRIVER_REGISTRY_SLOTS */
+#define UART_DRIVER_SLOT(instance) ((((uintptr_t)(instance)) >> 10U) & (UART_DRIVER_REGISTRY_SLOTS - 1U))
+
+static uart_driver_t *uart_driver_registry[UART_DRIVER_REGISTRY_SLOTS];
+
+static void uart_driver_start_tx(uart_driver_t *uart_driver);
+static bool uart_driver_start_rx(uart_driver_t *uart_driver);
+
+/**
+ * @brief TX ring bytes that go out before the next block queued by reference.
+ *
+ * The TX ring is in power-of-two mode, so its indices are free-running
+ * byte counts and the difference is exact across wraps.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @return Byte count, SIZE_MAX if no block is queued.
+ */
+static inline size_t uart_driver_tx_ring_limit(const uart_driver_t *uart_driver) {
+    return uart_driver->tx_ref_valid ? (uart_driver->tx_ref.mark - uart_driver->ring_buffer_tx.tail) : SIZE_MAX;
+}
+
+/**
+ * @brief Whether anything is queued for the transmitter, in the ring or by reference.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @return true if there is something to send.
+ */
+static inline bool uart_driver_tx_has_data(uart_driver_t *uart_driver) {
+    return uart_driver->tx_ref_valid || !ring_buffer_is_empty(&uart_driver->ring_buffer_tx);
+}
+
+/**
+ * @brief Marks bytes of the current block by reference as sent.
+ *
+ * Moves on to the next queued block once it is done.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param length Bytes sent.
+ */
+static void uart_driver_tx_ref_consume(uart_driver_t *uart_driver, size_t length) {
+    uart_driver->tx_ref.data += length;
+    uart_driver->tx_ref.length -= length;
+    uart_driver->tx_ref_bytes -= length;
+    if (uart_driver->tx_ref.length == 0U) {
+        uart_driver->tx_ref_valid = element_ring_pop(&uart_driver->tx_refs, &uart_driver->tx_ref);
+    }
+}
+
+/**
+ * @brief Takes the next byte to send, from the ring or the current block by reference.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param byte Pointer to store the byte.
+ * @return true if a byte was taken, false if nothing is queued.
+ */
+static inline bool uart_driver_tx_pop(uart_driver_t *uart_driver, uint8_t *byte) {
+    if (uart_driver_tx_ring_limit(uart_driver) == 0U) {
+        *byte = *uart_driver->tx_ref.data;
+        uart_driver_tx_ref_consume(uart_driver, 1U);
+        return true;
+    }
+
+    return ring_buffer_pop_fast(&uart_driver->ring_buffer_tx, byte);
+}
+
+/**
+ * @brief Releases what the DMA transfer that just ended carried.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @return Number of bytes it carried.
+ */
+static size_t uart_driver_tx_release(uart_driver_t *uart_driver) {
+    size_t length = uart_driver->tx_dma_length + uart_driver->tx_ref_sending;
+
+    if (uart_driver->tx_dma_length > 0U) {
+        (void) ring_buffer_read_commit(&uart_driver->ring_buffer_tx, uart_driver->tx_dma_length);
+        uart_driver->tx_dma_length = 0U;
+    }
+    if (uart_driver->tx_ref_sending > 0U) {
+        uart_driver_tx_ref_consume(uart_driver, uart_driver->tx_ref_sending);
+        uart_driver->tx_ref_sending = 0U;
+    }
+    return length;
+}
+
+/**
+ * @brief Set tx_busy, accounting the time it was set so far.
+ *
+ * The span since the last call is added whenever tx_busy was already set,
+ * so calling it with true on every chunk keeps each span short enough for
+ * the 32-bit cycle counter. Must be called with interrupts masked or from
+ * the TX interrupt.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param busy New tx_busy value.
+ */
+static inline void uart_driver_set_tx_busy(uart_driver_t *uart_driver, bool busy) {
+    uint32_t now = DWT->CYCCNT;
+
+    if (uart_driver->tx_busy) {
+        uart_driver->tx_busy_cycles += now - uart_driver->tx_busy_since;
+    }
+    uart_driver->tx_busy_since = now;
+    uart_driver->tx_busy = busy;
+}
+
+/**
+ * @brief Drive the RTS output, active low.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param ready true to let the peer send, false to stop it.
+ */
+static inline void uart_driver_rts_write(uart_driver_t *uart_driver, bool ready) {
+    if (uart_driver->rts_port != NULL) {
+        HAL_GPIO_WritePin(uart_driver->rts_port, uart_driver->rts_pin, ready ? GPIO_PIN_RESET : GPIO_PIN_SET);
+    }
+}
+
+/**
+ * @brief Queue XON or XOFF ahead of the TX ring and start the transmitter.
+ *
+ * Only the latest request is kept: an XOFF replaced by XON before it went
+ * out never stopped the peer in the first place.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param flow_char UART_DRIVER_XON or UART_DRIVER_XOFF.
+ */
+static void uart_driver_send_flow_char(uart_driver_t *uart_driver, uint8_t flow_char) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    uart_driver->tx_flow_char = flow_char;
+
+    __set_PRIMASK(primask);
+
+    uart_driver_start_tx(uart_driver);
+}
+
+/**
+ * @brief Stop the peer if the RX ring reached the high-water mark.
+ *
+ * RX interrupt side, after bytes were added to the ring. Deasserts RTS
+ * and/or sends XOFF, whichever is enabled.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ */
+static inline void uart_driver_rx_throttle(uart_driver_t *uart_driver) {
+    if ((uart_driver->flow_control || uart_driver->xon_xoff) &&
+        flow_control_on_produce(&uart_driver->rx_flow, ring_buffer_get_count(&uart_driver->ring_buffer_rx))) {
+        uart_driver_rts_write(uart_driver, false);
+        if (uart_driver->xon_xoff) {
+            uart_driver_send_flow_char(uart_driver, UART_DRIVER_XOFF);
+        }
+    }
+}
+
+/**
+ * @brief Let the peer resume once the RX ring is down to the low-water mark.
+ *
+ * Application side, after bytes were read. Runs with interrupts masked so
+ * the RX interrupt cannot stop the peer between the check and the write.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ */
+static void uart_driver_rx_unthrottle(uart_driver_t *uart_driver) {
+    if (!flow_control_is_stopped(&uart_driver->rx_flow)) {
+        return;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (flow_control_on_consume(&uart_driver->rx_flow, ring_buffer_get_count(&uart_driver->ring_buffer_rx))) {
+        uart_driver_rts_write(uart_driver, true);
+        if (uart_driver->xon_xoff) {
+            uart_driver_send_flow_char(uart_driver, UART_DRIVER_XON);
+        }
+    }
+
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Release a stopped peer and start the watermark state over.
+ *
+ * Must be called with interrupts masked; the XON it may queue goes out on
+ * the next uart_driver_start_tx().
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ */
+static void uart_driver_rx_flow_reset(uart_driver_t *uart_driver) {
+    if (uart_driver->xon_xoff && flow_control_is_stopped(&uart_driver->rx_flow)) {
+        uart_driver->tx_flow_char = UART_DRIVER_XON;
+    }
+    uart_driver_rts_write(uart_driver, true);
+    (void) flow_control_init(&uart_driver->rx_flow, UART_DRIVER_RX_LOW_WATER, UART_DRIVER_RX_HIGH_WATER);
+}
+
+/**
+ * @brief Act on XON/XOFF received from the peer.
+ *
+ * XOFF pauses the TX ring drain, XON resumes it.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param byte Received byte.
+ * @return true if byte was XON or XOFF and XON/XOFF is enabled.
+ */
+static bool uart_driver_rx_flow_char(uart_driver_t *uart_driver, uint8_t byte) {
+    if (!uart_driver->xon_xoff) {
+        return false;
+    }
+
+    if (byte == UART_DRIVER_XOFF) {
+        if (!uart_driver->tx_paused) {
+            uart_driver->tx_paused = true;
+            uart_driver->tx_pause_count++;
+        }
+        return true;
+    }
+
+    if (byte == UART_DRIVER_XON) {
+        if (uart_driver->tx_paused) {
+            uart_driver->tx_paused = false;
+            uart_driver_start_tx(uart_driver);
+        }
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Stop the register-level transmitter once the TX ring is empty or paused.
+ *
+ * Rechecks the ring with interrupts masked, so bytes queued by a higher
+ * priority ISR after the pop failed are still sent: TXEIE then stays set
+ * and the interrupt fires again at once.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ */
+static void uart_driver_irq_tx_stop(uart_driver_t *uart_driver) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    if ((uart_driver->tx_flow_char == 0U) && (uart_driver->tx_paused || !uart_driver_tx_has_data(uart_driver))) {
+        __HAL_UART_DISABLE_IT(uart_driver->huart, UART_IT_TXE);
+        uart_driver_set_tx_busy(uart_driver, false);
+    }
+
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Count the errors of one interrupt.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param error HAL_UART_ERROR_* flags.
+ */
+static void uart_driver_count_errors(uart_driver_t *uart_driver, uint32_t error) {
+    if ((error & HAL_UART_ERROR_ORE) != 0U) {
+        uart_driver->errors.overrun++;
+    }
+    if ((error & HAL_UART_ERROR_FE) != 0U) {
+        uart_driver->errors.framing++;
+    }
+    if ((error & HAL_UART_ERROR_NE) != 0U) {
+        uart_driver->errors.noise++;
+    }
+    if ((error & HAL_UART_ERROR_PE) != 0U) {
+        uart_driver->errors.parity++;
+    }
+    if ((error & HAL_UART_ERROR_DMA) != 0U) {
+        uart_driver->errors.dma++;
+    }
+}
+
+/**
+ * @brief Register-level UART interrupt handler.
+ *
+ * Reads SR once, then serves RXNE and TXE straight from DR. Reading DR
+ * after SR also clears ORE/NE/FE/PE, so an overrun never leaves the
+ * interrupt stuck; the flags seen are counted. A byte with a framing,
+ * noise or parity error is still stored. TXE is only served while TXEIE is enabled, i.e. while
+ * the driver owns the transmitter.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @return true if handled, false with the HAL backend.
+ */
+bool uart_driver_irq_handler(uart_driver_t *uart_driver) {
+    if ((uart_driver == NULL) || (uart_driver->backend != UART_DRIVER_BACKEND_REGISTER)) {
+        return false;
+    }
+
+    USART_TypeDef *usart = uart_driver->huart->Instance;
+    uint32_t status = usart->SR;
+
+    if ((status & (USART_SR_RXNE | USART_SR_ORE)) != 0U) {
+        uint8_t byte = (uint8_t) usart->DR;
+        if ((status & (USART_SR_ORE | USART_SR_FE | USART_SR_NE | USART_SR_PE)) != 0U) {
+            uart_driver_count_errors(uart_driver,
+                                     (((status & USART_SR_ORE) != 0U) ? HAL_UART_ERROR_ORE : 0U) |
+                                     (((status & USART_SR_FE) != 0U) ? HAL_UART_ERROR_FE : 0U) |
+                                     (((status & USART_SR_NE) != 0U) ? HAL_UART_ERROR_NE : 0U) |
+                                     (((status & USART_SR_PE) != 0U) ? HAL_UART_ERROR_PE : 0U));
+        }
+        UART_DRIVER_RX_BYTES(uart_driver, 1U);
+        if (!uart_driver_rx_flow_char(uart_driver, byte)) {
+            (void) ring_buffer_push_fast(&uart_driver->ring_buffer_rx, byte);
+            uart_driver_rx_throttle(uart_driver);
+        }
+    }
+
+    if (((status & USART_SR_TXE) != 0U) && ((usart->CR1 & USART_CR1_TXEIE) != 0U)) {
+        uint8_t byte = uart_driver->tx_flow_char;
+        if (byte != 0U) {
+            usart->DR = byte;
+            uart_driver->tx_flow_char = 0U;
+        } else if (!uart_driver->tx_paused && uart_driver_tx_pop(uart_driver, &byte)) {
+            usart->DR = byte;
+            UART_DRIVER_TX_BYTES(uart_driver, 1U);
+            uart_driver_set_tx_busy(uart_driver, true);
+        } else {
+            uart_driver_irq_tx_stop(uart_driver);
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief UART RX interrupt callback.
+ *
+ * Call this from the UART RX complete interrupt handler.
+ * Pushes the received byte into the RX ring buffer and restarts reception.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ */
+void uart_driver_rx_it_callback(uart_driver_t *uart_driver) {
+    if ((uart_driver == NULL) || (uart_driver->huart == NULL)) {
+        return;
+    }
+
+    UART_DRIVER_RX_BYTES(uart_driver, 1U);
+    if (!uart_driver_rx_flow_char(uart_driver, uart_driver->rx_byte)) {
+        (void) ring_buffer_push_fast(&uart_driver->ring_buffer_rx, uart_driver->rx_byte);
+        uart_driver_rx_throttle(uart_driver);
+    }
+    HAL_UART_Receive_IT(uart_driver->huart, (uint8_t *) &uart_driver->rx_byte, 1);
+}
+
+/**
+ * @brief UART RX event callback for circular DMA reception.
+ *
+ * The DMA stream writes straight into the RX ring storage, so the bytes
+ * between the last published position and the new one only need to be
+ * published by advancing the ring head. HAL reports the end of the buffer
+ * as position == size, which wraps to offset 0. With XON/XOFF enabled the
+ * new bytes are scanned for the peer's XON/XOFF, which stay in the ring.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param position Offset in the RX buffer the DMA stream has written up to.
+ */
+void uart_driver_rx_event_callback(uart_driver_t *uart_driver, uint16_t position) {
+    if ((uart_driver == NULL) || (position > UART_DRIVER_MAX_RX_BUFFER)) {
+        return;
+    }
+
+    size_t last = uart_driver->rx_dma_position;
+    size_t received = (position >= last) ? (position - last) : (UART_DRIVER_MAX_RX_BUFFER - last + position);
+
+    if (received > 0U) {
+        if (uart_driver->xon_xoff) {
+            for (size_t i = 0; i < received; i++) {
+                (void) uart_driver_rx_flow_char(uart_driver,
+                                                uart_driver->rx_buffer[(last + i) & (UART_DRIVER_MAX_RX_BUFFER - 1U)]);
+            }
+        }
+        (void) ring_buffer_write_advance(&uart_driver->ring_buffer_rx, received);
+        UART_DRIVER_RX_BYTES(uart_driver, received);
+        uart_driver->rx_dma_position = (position == UART_DRIVER_MAX_RX_BUFFER) ? 0U : position;
+        uart_driver_rx_throttle(uart_driver);
+    }
+}
+
+/**
+ * @brief Drops unread RX bytes the circular DMA stream is overwriting.
+ *
+ * The stream keeps writing after the last published position, so once the
+ * application is a buffer behind, the oldest unread bytes already hold newer
+ * data. Called before every read in DMA mode: the bytes written since the
+ * last event, read from the stream's remaining count, plus
+ * UART_DRIVER_RX_DMA_GUARD must fit beside the unread ones, and the oldest
+ * of the rest are counted as dropped instead of being returned. Interrupts
+ * are masked so the count and the published position belong together.
+ * Reception ended by an error is re-armed here, on the consumer side.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ */
+static void uart_driver_rx_dma_sync(uart_driver_t *uart_driver) {
+    if (uart_driver->rx_mode != UART_DRIVER_RX_MODE_DMA) {
+        return;
+    }
+    if (uart_driver->rx_restart) {
+        (void) uart_driver_start_rx(uart_driver);
+        return;
+    }
+    if (uart_driver->huart->RxState != HAL_UART_STATE_BUSY_RX) {
+        return;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    size_t position = UART_DRIVER_MAX_RX_BUFFER - __HAL_DMA_GET_COUNTER(uart_driver->huart->hdmarx);
+    size_t pending = (position - uart_driver->rx_dma_position) & (UART_DRIVER_MAX_RX_BUFFER - 1U);
+    size_t ahead = pending + UART_DRIVER_RX_DMA_GUARD;
+    (void) ring_buffer_trim(&uart_driver->ring_buffer_rx,
+                            (ahead < UART_DRIVER_MAX_RX_BUFFER) ? (UART_DRIVER_MAX_RX_BUFFER - ahead) : 0U);
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Arm reception in the current RX mode.
+ *
+ * A circular DMA stream always starts at the beginning of the RX buffer, so
+ * the ring is emptied first to keep its head in step with the stream; the
+ * unread bytes are counted as dropped. That moves the consumer's tail, so in
+ * DMA mode it runs on the consumer side, with the stream stopped.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @return true if reception was started, false otherwise.
+ */
+static bool uart_driver_start_rx(uart_driver_t *uart_driver) {
+    if (uart_driver->backend == UART_DRIVER_BACKEND_REGISTER) {
+        __HAL_UART_ENABLE_IT(uart_driver->huart, UART_IT_RXNE);
+        return true;
+    }
+
+    if (uart_driver->rx_mode == UART_DRIVER_RX_MODE_DMA) {
+        (void) ring_buffer_trim(&uart_driver->ring_buffer_rx, 0U);
+        (void) ring_buffer_reset(&uart_driver->ring_buffer_rx);
+        uart_driver->rx_dma_position = 0U;
+        uart_driver->rx_restart = false;
+        uart_driver_rx_unthrottle(uart_driver);
+        return (HAL_UARTEx_ReceiveToIdle_DMA(uart_driver->huart, uart_driver->rx_buffer,
+                                             UART_DRIVER_MAX_RX_BUFFER) == HAL_OK);
+    }
+
+    return (HAL_UART_Receive_IT(uart_driver->huart, (uint8_t *) &uart_driver->rx_byte, 1) == HAL_OK);
+}
+
+/**
+ * @brief Hand the next chunk of the TX ring to the transmitter.
+ *
+ * IT mode pops one byte; DMA mode sends the largest contiguous readable
+ * region in one transfer and keeps it in the ring until it completes, so
+ * HAL reads ring memory directly. A pending XON/XOFF goes out first, on its
+ * own, and nothing else is sent while the peer has paused us. tx_busy is
+ * set before the transfer starts and cleared if there is nothing to send.
+ * With the register backend only
+ * TXEIE is enabled: TXE is already set on an idle transmitter, so
+ * uart_driver_irq_handler() runs at once and sends the first byte. Must be
+ * called with interrupts masked.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ */
+static void uart_driver_tx_next(uart_driver_t *uart_driver) {
+    uart_driver_set_tx_busy(uart_driver, true);
+
+    if (uart_driver->backend == UART_DRIVER_BACKEND_REGISTER) {
+        if ((uart_driver->tx_flow_char == 0U) && (uart_driver->tx_paused || !uart_driver_tx_has_data(uart_driver))) {
+            uart_driver_set_tx_busy(uart_driver, false);
+        } else {
+            __HAL_UART_ENABLE_IT(uart_driver->huart, UART_IT_TXE);
+            uart_driver->tx_transfer_count++;
+        }
+        return;
+    }
+
+    if (uart_driver->tx_flow_char != 0U) {
+        HAL_StatusTypeDef status;
+
+        // tx_dma_length stays 0, so completion releases nothing from the ring
+        uart_driver->tx_byte = uart_driver->tx_flow_char;
+        uart_driver->tx_flow_char = 0U;
+        if (uart_driver->tx_mode == UART_DRIVER_TX_MODE_DMA) {
+            status = HAL_UART_Transmit_DMA(uart_driver->huart, &uart_driver->tx_byte, 1);
+        } else {
+            status = HAL_UART_Transmit_IT(uart_driver->huart, &uart_driver->tx_byte, 1);
+        }
+
+        if (status != HAL_OK) {
+            uart_driver->tx_flow_char = uart_driver->tx_byte;
+            uart_driver_set_tx_busy(uart_driver, false);
+        } else {
+            uart_driver->tx_transfer_count++;
+        }
+        return;
+    }
+
+    if (uart_driver->tx_paused) {
+        uart_driver_set_tx_busy(uart_driver, false);
+        return;
+    }
+
+    if (uart_driver->tx_mode == UART_DRIVER_TX_MODE_DMA) {
+        size_t limit = uart_driver_tx_ring_limit(uart_driver);
+        uint8_t *region;
+        size_t length;
+
+        if (limit == 0U) {
+            // HAL only reads the buffer, it is not const in its prototype
+            region = (uint8_t *)uart_driver->tx_ref.data;
+            length = uart_driver->tx_ref.length;
+        } else {
+            length = ring_buffer_read_acquire(&uart_driver->ring_buffer_tx, &region);
+            if (length > limit) {
+                length = limit;
+            }
+        }
+
+        if (length > UINT16_MAX) {
+            length = UINT16_MAX;
+        }
+        if (uart_driver->xon_xoff && (length > UART_DRIVER_XON_XOFF_DMA_CHUNK)) {
+            length = UART_DRIVER_XON_XOFF_DMA_CHUNK;
+        }
+
+        if (limit == 0U) {
+            uart_driver->tx_ref_sending = length;
+        } else {
+            uart_driver->tx_dma_length = length;
+        }
+        if ((length == 0U) || (HAL_UART_Transmit_DMA(uart_driver->huart, region, (uint16_t)length) != HAL_OK)) {
+            uart_driver->tx_dma_length = 0U;
+            uart_driver->tx_ref_sending = 0U;
+            uart_driver_set_tx_busy(uart_driver, false);
+        } else {
+            uart_driver->tx_transfer_count++;
+        }
+        return;
+    }
+
+    if (!uart_driver_tx_pop(uart_driver, &uart_driver->tx_byte) ||
+        (HAL_UART_Transmit_IT(uart_driver->huart, &uart_driver->tx_byte, 1) != HAL_OK)) {
+        uart_driver_set_tx_busy(uart_driver, false);
+        return;
+    }
+    UART_DRIVER_TX_BYTES(uart_driver, 1U);
+    uart_driver->tx_transfer_count++;
+}
+
+/**
+ * @brief UART TX interrupt callback.
+ *
+ * Call this from the UART TX complete interrupt handler.
+ * Releases the bytes a DMA transfer just sent, then starts the next byte
+ * (IT mode) or region (DMA mode). If no more data is available, marks TX
+ * as not busy. This runs with interrupts masked so that a higher priority
+ * ISR queueing data cannot see tx_busy still set after the ring was found
+ * empty, which would strand its bytes.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ */
+void uart_driver_tx_it_callback(uart_driver_t *uart_driver) {
+    if ((uart_driver == NULL) || (uart_driver->huart == NULL)) {
+        return;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    size_t sent = uart_driver_tx_release(uart_driver);
+    if (sent > 0U) {
+        UART_DRIVER_TX_BYTES(uart_driver, sent);
+    }
+
+    uart_driver_tx_next(uart_driver);
+
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief UART error callback.
+ *
+ * HAL keeps reception going after a framing, noise or parity error in IT
+ * mode; the byte is delivered through the RX complete callback as usual.
+ * On overrun, and on any error while the RX DMA stream runs, it ends the
+ * reception and leaves RxState ready, which is what is checked here before
+ * re-arming. A DMA stream restarts at offset 0 and empties the RX ring, so
+ * that is left to the next read (uart_driver_rx_dma_sync()) instead of
+ * moving the tail under a consumer this interrupt may have preempted.
+ * tx_busy with the transmitter ready means HAL ended the TX
+ * transfer on a DMA error, since a completed one is chained in the TX
+ * complete callback before any other interrupt at this priority can run.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ */
+void uart_driver_error_callback(uart_driver_t *uart_driver) {
+    if ((uart_driver == NULL) || (uart_driver->huart == NULL)) {
+        return;
+    }
+
+    UART_HandleTypeDef *huart = uart_driver->huart;
+    uart_driver_count_errors(uart_driver, huart->ErrorCode);
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    if ((uart_driver->backend == UART_DRIVER_BACKEND_HAL) && uart_driver->tx_busy &&
+        (huart->gState == HAL_UART_STATE_READY)) {
+        (void) uart_driver_tx_release(uart_driver);
+        uart_driver_tx_next(uart_driver);
+    }
+
+    __set_PRIMASK(primask);
+
+    if ((huart->RxState == HAL_UART_STATE_READY) && !uart_driver->rx_restart) {
+        uart_driver->errors.rx_restarts++;
+        if (uart_driver->rx_mode == UART_DRIVER_RX_MODE_DMA) {
+            uart_driver->rx_restart = true;
+        } else {
+            (void) uart_driver_start_rx(uart_driver);
+        }
+    }
+}
+
+/**
+ * @brief Start transmission if the transmitter is idle.
+ *
+ * The TX ring has a single consumer: whoever observes tx_busy == false and
+ * sets it owns the transmitter until the TX complete callback clears it.
+ * The check-and-start runs with interrupts masked so the ISR cannot clear
+ * tx_busy between the check and the first pop, which would leave queued
+ * bytes stranded until the next send.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ */
+static void uart_driver_start_tx(uart_driver_t *uart_driver) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (!uart_driver->tx_busy) {
+        uart_driver_tx_next(uart_driver);
+    }
+
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Start transmission after queueing, unless write-combining defers it.
+ *
+ * A deferred send still starts the transmitter once the ring holds
+ * UART_DRIVER_TX_KICK_THRESHOLD bytes, or when the send did not fit and
+ * its caller is about to wait for room that only transmission can free.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param complete Whether everything the caller queued fit in the ring.
+ */
+static inline void uart_driver_tx_queued(uart_driver_t *uart_driver, bool complete) {
+    if (!uart_driver->tx_deferred || !complete ||
+        (ring_buffer_get_count(&uart_driver->ring_buffer_tx) >= UART_DRIVER_TX_KICK_THRESHOLD)) {
+        uart_driver_start_tx(uart_driver);
+    }
+}
+
+/**
+ * @brief Abort the transfer in flight and mark TX idle.
+ *
+ * The bytes of an aborted DMA transfer, from the ring or a block by
+ * reference, are released like the byte an aborted IT transfer already popped.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ */
+static void uart_driver_abort_tx(uart_driver_t *uart_driver) {
+    HAL_UART_AbortTransmit(uart_driver->huart);
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    (void) uart_driver_tx_release(uart_driver);
+    uart_driver_set_tx_busy(uart_driver, false);
+
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Drop everything still queued for the transmitter.
+ *
+ * Empties the TX ring and the queue of blocks by reference. Call it after
+ * uart_driver_abort_tx(), so no transfer owns ring bytes or a block.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ */
+static void uart_driver_discard_tx(uart_driver_t *uart_driver) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    (void) ring_buffer_reset(&uart_driver->ring_buffer_tx);
+    (void) element_ring_reset(&uart_driver->tx_refs);
+    uart_driver->tx_ref_valid = false;
+    uart_driver->tx_ref_bytes = 0U;
+
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Send data over UART using the driver.
+ *
+ * Copies the provided data into the TX ring buffer and starts transmission if not busy
+ * and not deferred. Bytes that do not fit in the TX ring are not queued; the return value tells how many were.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param data Pointer to data buffer to send.
+ * @param length Number of bytes to send.
+ * @return Number of bytes successfully queued for transmission.
+ */
+size_t uart_driver_send(uart_driver_t *uart_driver, uint8_t *data, size_t length) {
+    if ((uart_driver == NULL) || (data == NULL) || (length == 0)) {
+        return 0U;
+    }
+
+    size_t queued = ring_buffer_write(&uart_driver->ring_buffer_tx, data, length);
+
+    uart_driver_tx_queued(uart_driver, queued == length);
+
+    return queued;
+}
+
+/**
+ * @brief Queue a block for transmission by reference.
+ *
+ * The block's mark is the TX ring write index at the call. In thread mode
+ * with interrupts masked no producer is halfway through a write, so the
+ * index covers every byte queued before the call, in multi-producer mode
+ * too.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param data Block to send.
+ * @param length Number of bytes.
+ * @return true if queued, false otherwise.
+ */
+bool uart_driver_send_ref(uart_driver_t *uart_driver, const uint8_t *data, size_t length) {
+    if ((uart_driver == NULL) || (data == NULL) || (length == 0U) || (__get_IPSR() != 0U)) {
+        return false;
+    }
+
+    uart_driver_tx_ref_t ref = { .data = data, .length = length };
+    bool queued = true;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    ref.mark = uart_driver->ring_buffer_tx.head;
+    if (!uart_driver->tx_ref_valid) {
+        uart_driver->tx_ref = ref;
+        uart_driver->tx_ref_valid = true;
+    } else {
+        queued = element_ring_push(&uart_driver->tx_refs, &ref);
+    }
+    if (queued) {
+        uart_driver->tx_ref_bytes += length;
+    }
+
+    __set_PRIMASK(primask);
+
+    if (queued) {
+        uart_driver_tx_queued(uart_driver, true);
+    }
+    return queued;
+}
+
+/**
+ * @brief Whether a blocking call can wait for the transmitter here.
+ *
+ * The TX interrupts that free ring space cannot run while an ISR or a
+ * masked section waits for them.
+ *
+ * @return true in thread mode with interrupts enabled.
+ */
+static inline bool uart_driver_can_wait(void) {
+    return (__get_IPSR() == 0U) && (__get_PRIMASK() == 0U);
+}
+
+/**
+ * @brief One wait step of a blocking call.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param start HAL tick when the call started.
+ * @param timeout_ms Maximum time to wait, or UART_DRIVER_WAIT_FOREVER.
+ * @return true to keep waiting, false once the timeout has expired or waiting is not possible.
+ */
+static bool uart_driver_wait(uart_driver_t *uart_driver, uint32_t start, uint32_t timeout_ms) {
+    if (!uart_driver_can_wait() ||
+        ((timeout_ms != UART_DRIVER_WAIT_FOREVER) && ((HAL_GetTick() - start) >= timeout_ms))) {
+        return false;
+    }
+
+    if (uart_driver->idle_hook != NULL) {
+        uart_driver->idle_hook(uart_driver->idle_context);
+    }
+    return true;
+}
+
+/**
+ * @brief Send data, waiting for TX ring space until all of it is queued.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param data Pointer to data buffer to send.
+ * @param length Number of bytes to send.
+ * @param timeout_ms Maximum time to wait in milliseconds.
+ * @return Number of bytes successfully queued for transmission.
+ */
+size_t uart_driver_send_timeout(uart_driver_t *uart_driver, uint8_t *data, size_t length, uint32_t timeout_ms) {
+    if ((uart_driver == NULL) || (data == NULL) || (length == 0)) {
+        return 0U;
+    }
+
+    uint32_t start = HAL_GetTick();
+    size_t queued = uart_driver_send(uart_driver, data, length);
+
+    while ((queued < length) && uart_driver_wait(uart_driver, start, timeout_ms)) {
+        queued += uart_driver_send(uart_driver, &data[queued], length - queued);
+    }
+
+    return queued;
+}
+
+/**
+ * @brief Wait until everything queued has left the line.
+ *
+ * tx_busy only covers the ring; the last byte may still be in the shift
+ * register (always so with the register backend), hence the TC flag.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param timeout_ms Maximum time to wait in milliseconds.
+ * @return true if the transmitter is idle, false otherwise.
+ */
+bool uart_driver_flush(uart_driver_t *uart_driver, uint32_t timeout_ms) {
+    if ((uart_driver == NULL) || (uart_driver->huart == NULL)) {
+        return false;
+    }
+
+    uint32_t start = HAL_GetTick();
+
+    uart_driver_tx_kick(uart_driver);
+    while (uart_driver->tx_busy || uart_driver_tx_has_data(uart_driver)) {
+        if (!uart_driver_wait(uart_driver, start, timeout_ms)) {
+            return false;
+        }
+    }
+
+    while (__HAL_UART_GET_FLAG(uart_driver->huart, UART_FLAG_TC) == RESET) {
+        if (!uart_driver_wait(uart_driver, start, timeout_ms)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Set the function run while blocking calls wait.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param hook Function to run, NULL to busy-wait.
+ * @param context Argument passed to hook.
+ * @return true if set, false otherwise.
+ */
+bool uart_driver_set_idle_hook(uart_driver_t *uart_driver, uart_driver_idle_hook_t hook, void *context) {
+    if (uart_driver == NULL) {
+        return false;
+    }
+
+    uart_driver->idle_context = context;
+    uart_driver->idle_hook = hook;
+    return true;
+}
+
+/**
+ * @brief Enable or disable write-combining of output.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param enable true to defer transmission to uart_driver_tx_kick().
+ * @return true if applied, false otherwise.
+ */
+bool uart_driver_set_tx_deferred(uart_driver_t *uart_driver, bool enable) {
+    if (uart_driver == NULL) {
+        return false;
+    }
+
+    uart_driver->tx_deferred = enable;
+    if (!enable) {
+        uart_driver_tx_kick(uart_driver);
+    }
+    return true;
+}
+
+/**
+ * @brief Start sending queued output if the transmitter is idle.
+ *
+ * The unlocked checks only skip the masked section when there is clearly
+ * nothing to do; uart_driver_start_tx() decides under the mask.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ */
+void uart_driver_tx_kick(uart_driver_t *uart_driver) {
+    if ((uart_driver == NULL) || uart_driver->tx_busy ||
+        (!uart_driver_tx_has_data(uart_driver) && (uart_driver->tx_flow_char == 0U))) {
+        return;
+    }
+
+    uart_driver_start_tx(uart_driver);
+}
+
 /**
- * @brief UART RX interrupt callback.
+ * @brief Gets the largest contiguous free region of the TX ring buffer.
  *
- * Call this from the UART RX complete interrupt handler.
- * Pushes the received byte into the RX ring buffer and restarts reception.
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param region Pointer to store the start of the writable region.
+ * @return Size of the region in bytes.
+ */
+size_t uart_driver_tx_acquire(uart_driver_t *uart_driver, uint8_t **region) {
+    if (uart_driver == NULL) {
+        return 0U;
+    }
+
+    return ring_buffer_write_acquire(&uart_driver->ring_buffer_tx, region);
+}
+
+/**
+ * @brief Queues bytes written into a region from uart_driver_tx_acquire().
+ *
+ * Publishes the bytes to the TX ring buffer and starts transmission if not busy
+ * and not deferred.
  *
  * @param uart_driver Pointer to uart_driver_t structure.
+ * @param length Number of bytes written into the region.
+ * @return true if the bytes were queued, false otherwise.
  */
-void uart_driver_rx_it_callback(uart_driver_t *uart_driver) {
-    if ((uart_driver == NULL) || (uart_driver->huart == NULL)) {
-        return;
+bool uart_driver_tx_commit(uart_driver_t *uart_driver, size_t length) {
+    if ((uart_driver == NULL) || !ring_buffer_write_commit(&uart_driver->ring_buffer_tx, length)) {
+        return false;
     }
 
-    (void) ring_buffer_push(&uart_driver->ring_buffer_rx, uart_driver->rx_byte);
-    HAL_UART_Receive_IT(uart_driver->huart, (uint8_t *) &uart_driver->rx_byte, 1);
+    if (length > 0U) {
+        uart_driver_tx_queued(uart_driver, true);
+    }
+    return true;
 }
 
 /**
- * @brief UART TX interrupt callback.
+ * @brief Get a single received byte from the RX ring buffer.
  *
- * Call this from the UART TX complete interrupt handler.
- * Pops the next byte from the TX ring buffer and transmits it.
- * If no more data is available, marks TX as not busy.
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param byte Pointer to variable to store the received byte.
+ * @return true if a byte was received, false otherwise.
+ */
+bool uart_driver_get_byte(uart_driver_t *uart_driver, uint8_t *byte) {
+    if ((uart_driver == NULL) || (byte == NULL)) {
+        return false;
+    }
+
+    uart_driver_rx_dma_sync(uart_driver);
+    if (!ring_buffer_pop_fast(&uart_driver->ring_buffer_rx, byte)) {
+        return false;
+    }
+
+    uart_driver_rx_unthrottle(uart_driver);
+    return true;
+}
+
+/**
+ * @brief Get up to length received bytes from the RX ring buffer.
  *
  * @param uart_driver Pointer to uart_driver_t structure.
+ * @param buffer Pointer to destination buffer.
+ * @param length Maximum number of bytes to read.
+ * @return Number of bytes copied into buffer.
  */
-void uart_driver_tx_it_callback(uart_driver_t *uart_driver) {
+size_t uart_driver_get_bytes(uart_driver_t *uart_driver, uint8_t *buffer, size_t length) {
+    if ((uart_driver == NULL) || (buffer == NULL)) {
+        return 0U;
+    }
+
+    uart_driver_rx_dma_sync(uart_driver);
+    size_t count = ring_buffer_read(&uart_driver->ring_buffer_rx, buffer, length);
+
+    uart_driver_rx_unthrottle(uart_driver);
+    return count;
+}
+
+/**
+ * @brief Finds a byte in the received data without consuming it.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param byte Byte to look for.
+ * @param position Pointer to store the number of bytes received before it.
+ * @return true if the byte has been received, false otherwise.
+ */
+bool uart_driver_find_byte(uart_driver_t *uart_driver, uint8_t byte, size_t *position) {
+    if (uart_driver == NULL) {
+        return false;
+    }
+
+    uart_driver_rx_dma_sync(uart_driver);
+    return ring_buffer_find(&uart_driver->ring_buffer_rx, byte, position);
+}
+
+/**
+ * @brief Get the number of received bytes waiting to be read.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @return Byte count.
+ */
+size_t uart_driver_rx_available(uart_driver_t *uart_driver) {
+    if (uart_driver == NULL) {
+        return 0U;
+    }
+
+    uart_driver_rx_dma_sync(uart_driver);
+    return ring_buffer_get_count(&uart_driver->ring_buffer_rx);
+}
+
+/**
+ * @brief Enable or disable RTS/CTS hardware flow control.
+ *
+ * HwFlowCtl is updated in the handle as well, so a later
+ * uart_driver_reconfigure() keeps CTS. The peer is always released on a
+ * change, the watermark state starts over.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param enable true to enable, false to disable.
+ * @param rts_port RTS output port, or NULL for CTS only.
+ * @param rts_pin RTS output pin.
+ * @return true if applied, false otherwise.
+ */
+bool uart_driver_set_flow_control(uart_driver_t *uart_driver, bool enable, GPIO_TypeDef *rts_port, uint16_t rts_pin) {
     if ((uart_driver == NULL) || (uart_driver->huart == NULL)) {
-        return;
+        return false;
     }
 
-    uint8_t next;
-    if (ring_buffer_pop(&uart_driver->ring_buffer_tx, &next)) {
-        HAL_UART_Transmit_IT(uart_driver->huart, &next, 1);
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    uart_driver_rx_flow_reset(uart_driver);
+    uart_driver->rts_port = enable ? rts_port : NULL;
+    uart_driver->rts_pin = rts_pin;
+    uart_driver_rts_write(uart_driver, true);
+    uart_driver->flow_control = enable;
 
+    uart_driver->huart->Init.HwFlowCtl = enable ? UART_HWCONTROL_CTS : UART_HWCONTROL_NONE;
+    if (enable) {
+        SET_BIT(uart_driver->huart->Instance->CR3, USART_CR3_CTSE);
     } else {
-        uart_driver->tx_busy = false;
+        CLEAR_BIT(uart_driver->huart->Instance->CR3, USART_CR3_CTSE);
     }
+
+    __set_PRIMASK(primask);
+
+    uart_driver_start_tx(uart_driver);
+
+    // Already above the high-water mark: stop the peer right away
+    __disable_irq();
+    uart_driver_rx_throttle(uart_driver);
+    __set_PRIMASK(primask);
+    return true;
 }
 
 /**
- * @brief Send data over UART using the driver.
+ * @brief Enable or disable XON/XOFF software flow control.
  *
- * Pushes the provided data into the TX ring buffer and starts transmission if not busy.
+ * A peer stopped with XOFF gets XON, and a pause requested by the peer is
+ * dropped, so switching never leaves either side stuck.
  *
  * @param uart_driver Pointer to uart_driver_t structure.
- * @param data Pointer to data buffer to send.
- * @param length Number of bytes to send.
- * @return Number of bytes successfully queued for transmission.
+ * @param enable true to enable, false to disable.
+ * @return true if applied, false otherwise.
  */
-size_t uart_driver_send(uart_driver_t *uart_driver, uint8_t *data, size_t length) {
-    if ((data == NULL) || (length == 0)) {
-        return 0U;
+bool uart_driver_set_xon_xoff(uart_driver_t *uart_driver, bool enable) {
+    if ((uart_driver == NULL) || (uart_driver->huart == NULL)) {
+        return false;
     }
 
-    for (size_t data_idx = 0; data_idx < length; data_idx++) {
-        ring_buffer_push(&uart_driver->ring_buffer_tx, data[data_idx]);
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    uart_driver_rx_flow_reset(uart_driver);
+    uart_driver->xon_xoff = enable;
+    uart_driver->tx_paused = false;
+
+    __set_PRIMASK(primask);
+
+    uart_driver_start_tx(uart_driver);
+
+    // Already above the high-water mark: stop the peer right away
+    __disable_irq();
+    uart_driver_rx_throttle(uart_driver);
+    __set_PRIMASK(primask);
+    return true;
+}
+
+/**
+ * @brief Get the flow control counters.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param stats Pointer to store the counters.
+ * @return true if successful, false otherwise.
+ */
+bool uart_driver_get_flow_stats(uart_driver_t *uart_driver, uart_driver_flow_stats_t *stats) {
+    if ((uart_driver == NULL) || (stats == NULL)) {
+        return false;
     }
 
-    if (!uart_driver->tx_busy) {
-        uint8_t first;
-        if (ring_buffer_pop(&uart_driver->ring_buffer_tx, &first)) {
-            uart_driver->tx_busy = true;
-            HAL_UART_Transmit_IT(uart_driver->huart, &first, 1);
-        } else {
-            return 0U;
-        }
+    stats->rx_throttled = uart_driver->rx_flow.stop_count;
+    stats->tx_paused = uart_driver->tx_pause_count;
+    return true;
+}
+
+/**
+ * @brief Copy the receive and DMA error counters.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param errors Pointer to store the counters.
+ * @return true if copied, false otherwise.
+ */
+bool uart_driver_get_errors(uart_driver_t *uart_driver, uart_driver_errors_t *errors) {
+    if ((uart_driver == NULL) || (errors == NULL)) {
+        return false;
     }
 
-    return length;
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    *errors = uart_driver->errors;
+    __set_PRIMASK(primask);
+    return true;
 }
 
 /**
- * @brief Get a single received byte from the RX ring buffer.
+ * @brief Clear the receive and DMA error counters.
  *
  * @param uart_driver Pointer to uart_driver_t structure.
- * @param byte Pointer to variable to store the received byte.
- * @return true if a byte was received, false otherwise.
+ * @return true if cleared, false otherwise.
  */
-bool uart_driver_get_byte(uart_driver_t *uart_driver, uint8_t *byte) {
-    if ((uart_driver == NULL) || (byte == NULL)) {
+bool uart_driver_reset_errors(uart_driver_t *uart_driver) {
+    if (uart_driver == NULL) {
+        return false;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uart_driver->errors = (uart_driver_errors_t) { 0 };
+    __set_PRIMASK(primask);
+    return true;
+}
+
+/**
+ * @brief Copy the traffic and buffer usage counters.
+ *
+ * A transmission in progress is accounted up to now first.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param stats Pointer to store the counters.
+ * @return true if copied, false otherwise.
+ */
+bool uart_driver_get_stats(uart_driver_t *uart_driver, uart_driver_stats_t *stats) {
+    if ((uart_driver == NULL) || (stats == NULL)) {
+        return false;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (uart_driver->tx_busy) {
+        uart_driver_set_tx_busy(uart_driver, true);
+    }
+    uint64_t busy_cycles = uart_driver->tx_busy_cycles;
+    stats->elapsed_ms = HAL_GetTick() - uart_driver->stats_tick;
+    stats->rx_bytes = uart_driver->rx_count;
+    stats->tx_bytes = uart_driver->tx_count;
+    stats->tx_transfers = uart_driver->tx_transfer_count;
+    stats->rx_dropped = ring_buffer_get_dropped(&uart_driver->ring_buffer_rx);
+    stats->tx_dropped = ring_buffer_get_dropped(&uart_driver->ring_buffer_tx);
+    stats->rx_high_water = ring_buffer_get_high_water(&uart_driver->ring_buffer_rx);
+    stats->tx_high_water = ring_buffer_get_high_water(&uart_driver->ring_buffer_tx);
+
+    __set_PRIMASK(primask);
+
+    stats->tx_busy_ms = (uint32_t)(busy_cycles / (SystemCoreClock / 1000U));
+    return true;
+}
+
+/**
+ * @brief Clear the traffic and buffer usage counters.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @return true if cleared, false otherwise.
+ */
+bool uart_driver_reset_stats(uart_driver_t *uart_driver) {
+    if (uart_driver == NULL) {
+        return false;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    uart_driver->tx_busy_since = DWT->CYCCNT;
+    uart_driver->tx_busy_cycles = 0U;
+    uart_driver->rx_count = 0U;
+    uart_driver->tx_count = 0U;
+    uart_driver->tx_transfer_count = 0U;
+    uart_driver->stats_tick = HAL_GetTick();
+    (void) ring_buffer_reset_stats(&uart_driver->ring_buffer_rx);
+    (void) ring_buffer_reset_stats(&uart_driver->ring_buffer_tx);
+
+    __set_PRIMASK(primask);
+    return true;
+}
+
+/**
+ * @brief Kernel clock of the USART behind a driver.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @return Clock in Hz.
+ */
+static uint32_t uart_driver_get_pclk(uart_driver_t *uart_driver) {
+#if defined(USART6)
+    if ((uart_driver->huart->Instance == USART1) || (uart_driver->huart->Instance == USART6)) {
+#else
+    if (uart_driver->huart->Instance == USART1) {
+#endif
+        return HAL_RCC_GetPCLK2Freq();
+    }
+    return HAL_RCC_GetPCLK1Freq();
+}
+
+/**
+ * @brief Baud rate generated by the BRR value HAL computes.
+ *
+ * @param pclk USART kernel clock in Hz.
+ * @param baud_rate Requested baud rate.
+ * @param oversampling UART_OVERSAMPLING_16 or UART_OVERSAMPLING_8.
+ * @return Generated rate, 0 if USARTDIV falls outside 1..4095.
+ */
+static uint32_t uart_driver_baud_actual(uint32_t pclk, uint32_t baud_rate, uint32_t oversampling) {
+    uint32_t brr;
+    uint32_t divider;
+
+    if (oversampling == UART_OVERSAMPLING_8) {
+        brr = UART_BRR_SAMPLING8(pclk, baud_rate);
+        divider = ((brr >> 4U) << 3U) + (brr & 0x07U);
+    } else {
+        brr = UART_BRR_SAMPLING16(pclk, baud_rate);
+        divider = brr;
+    }
+
+    if (((brr >> 4U) == 0U) || (brr > 0xFFFFU)) {
+        return 0U;
+    }
+    return (pclk + (divider / 2U)) / divider;
+}
+
+/**
+ * @brief Check whether the USART can generate a baud rate.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param baud_rate Requested baud rate.
+ * @param actual Optional, closest rate generated.
+ * @param oversampling Optional, oversampling to use.
+ * @return true if within UART_DRIVER_BAUD_TOLERANCE, false otherwise.
+ */
+bool uart_driver_check_baud(uart_driver_t *uart_driver, uint32_t baud_rate, uint32_t *actual, uint32_t *oversampling) {
+    if ((uart_driver == NULL) || (uart_driver->huart == NULL) || (baud_rate == 0U)) {
         return false;
     }
 
-    return ring_buffer_pop(&uart_driver->ring_buffer_rx, byte);
+    // 16x first for its noise margin, 8x only if 16x is out of range or out of tolerance
+    static const uint32_t modes[] = { UART_OVERSAMPLING_16, UART_OVERSAMPLING_8 };
+    uint32_t pclk = uart_driver_get_pclk(uart_driver);
+    uint32_t best_rate = 0U;
+    uint32_t best_mode = UART_OVERSAMPLING_16;
+    uint32_t best_error = UINT32_MAX;
+
+    for (size_t i = 0; i < (sizeof(modes) / sizeof(modes[0])); i++) {
+        uint32_t rate = uart_driver_baud_actual(pclk, baud_rate, modes[i]);
+        uint32_t error = (rate > baud_rate) ? (rate - baud_rate) : (baud_rate - rate);
+
+        if ((rate != 0U) && (error < best_error)) {
+            best_rate = rate;
+            best_mode = modes[i];
+            best_error = error;
+        }
+        if ((best_rate != 0U) && (((uint64_t)best_error * 1000U) <= ((uint64_t)baud_rate * UART_DRIVER_BAUD_TOLERANCE))) {
+            break;
+        }
+    }
+
+    if (actual != NULL) {
+        *actual = best_rate;
+    }
+    if (oversampling != NULL) {
+        *oversampling = best_mode;
+    }
+    return (best_rate != 0U) && (((uint64_t)best_error * 1000U) <= ((uint64_t)baud_rate * UART_DRIVER_BAUD_TOLERANCE));
 }
 
 /**
  * @brief Reconfigure UART driver with a new baud rate.
  *
- * Aborts ongoing transmissions, deinitializes and reinitializes the UART peripheral with the new baud rate,
- * and restarts RX interrupt.
+ * Checks the rate first, then lets the TX ring drain at the old rate for
+ * as long as a full ring takes to send, plus a margin, before transfers
+ * are aborted. The peripheral is then deinitialized and reinitialized with
+ * the new rate and oversampling, and reception is restarted. In DMA RX
+ * mode unread bytes are discarded, since the stream restarts at the
+ * beginning of the buffer.
  *
  * @param uart_driver Pointer to uart_driver_t structure.
  * @param baud_rate New baud rate to configure.
  * @return true if reconfiguration succeeded, false otherwise.
  */
 bool uart_driver_reconfigure(uart_driver_t *uart_driver, uint32_t baud_rate) {
-    if ((uart_driver == NULL) || (uart_driver->huart == NULL) || (baud_rate == 0)) {
+    uint32_t oversampling;
+
+    if (!uart_driver_check_baud(uart_driver, baud_rate, NULL, &oversampling)) {
         return false;
     }
 
-    HAL_UART_AbortTransmit(uart_driver->huart);
+    // 10 bits per character (8N1); blocks sent by reference can be far longer than the ring
+    uint32_t old_rate = uart_driver->huart->Init.BaudRate;
+    uint64_t pending = (uint64_t) UART_DRIVER_MAX_TX_BUFFER + uart_driver->tx_ref_bytes;
+    uint32_t drain_ms = (old_rate > 0U) ? (uint32_t) ((pending * 10000U) / old_rate) + 10U : 0U;
+    bool drained = uart_driver_flush(uart_driver, drain_ms);
+
+    uart_driver_abort_tx(uart_driver);
+    if (!drained) {
+        // A peer still at the old rate would read what is left as garbage at the new one
+        uart_driver_discard_tx(uart_driver);
+    }
     HAL_UART_AbortReceive(uart_driver->huart);
 
     if (HAL_UART_DeInit(uart_driver->huart) != HAL_OK) {
@@ -120,12 +1368,17 @@ bool uart_driver_reconfigure(uart_driver_t *uart_driver, uint32_t baud_rate) {
     }
 
     uart_driver->huart->Init.BaudRate = baud_rate;
+    uart_driver->huart->Init.OverSampling = oversampling;
 
     if (HAL_UART_Init(uart_driver->huart) != HAL_OK) {
         return false;
     }
 
-    HAL_UART_Receive_IT(uart_driver->huart, (uint8_t *) &uart_driver->rx_byte, 1);
+    // The watermark state outlives the re-init; a peer stopped above the high-water mark stays stopped
+    uart_driver_rts_write(uart_driver, !flow_control_is_stopped(&uart_driver->rx_flow));
+
+    (void) uart_driver_start_rx(uart_driver);
+    uart_driver_start_tx(uart_driver);
 
     return true;
 }
@@ -145,10 +1398,179 @@ bool uart_driver_init(uart_driver_t *uart_driver, UART_HandleTypeDef *huart) {
     }
 
     uart_driver->huart = huart;
+    uart_driver->backend = UART_DRIVER_BACKEND;
+    uart_driver->flow_control = false;
+    uart_driver->rts_port = NULL;
+    uart_driver->rts_pin = 0U;
+    (void) flow_control_init(&uart_driver->rx_flow, UART_DRIVER_RX_LOW_WATER, UART_DRIVER_RX_HIGH_WATER);
+    uart_driver->xon_xoff = false;
+    uart_driver->tx_flow_char = 0U;
+    uart_driver->tx_paused = false;
+    uart_driver->tx_pause_count = 0U;
+    uart_driver->errors = (uart_driver_errors_t) { 0 };
+    uart_driver->idle_hook = NULL;
+    uart_driver->idle_context = NULL;
+    uart_driver->profile = (uart_driver_profile_t) { 0 };
     uart_driver->tx_busy = false;
+    uart_driver->tx_busy_cycles = 0U;
+    uart_driver->rx_count = 0U;
+    uart_driver->tx_count = 0U;
+    uart_driver->tx_transfer_count = 0U;
+    uart_driver->rx_mode = UART_DRIVER_RX_MODE;
+    uart_driver->rx_dma_position = 0U;
+    uart_driver->rx_restart = false;
+    uart_driver->tx_mode = UART_DRIVER_TX_MODE;
+    uart_driver->tx_dma_length = 0U;
+    uart_driver->tx_deferred = (UART_DRIVER_TX_DEFERRED != 0);
+    (void) element_ring_init(&uart_driver->tx_refs, uart_driver->tx_ref_storage, sizeof(uart_driver_tx_ref_t),
+                             UART_DRIVER_TX_REF_QUEUE);
+    uart_driver->tx_ref_valid = false;
+    uart_driver->tx_ref_sending = 0U;
+    uart_driver->tx_ref_bytes = 0U;
 
-    ring_buffer_init(&uart_driver->ring_buffer_rx, uart_driver->rx_buffer, UART_DRIVER_MAX_RX_BUFFER);
-    ring_buffer_init(&uart_driver->ring_buffer_tx, uart_driver->tx_buffer, UART_DRIVER_MAX_TX_BUFFER);
+    // The ISR cannot retry, so RX counts what it loses; TX hands the partial count back to the caller
+    uart_driver->ring_buffer_rx = (ring_buffer_t) RING_BUFFER_INITIALIZER(uart_driver->rx_buffer, UART_DRIVER_RX_POLICY);
+    uart_driver->ring_buffer_tx = (ring_buffer_t) UART_DRIVER_TX_RING_INITIALIZER(uart_driver->tx_buffer);
 
-    return (HAL_UART_Receive_IT(uart_driver->huart, (uint8_t *) &uart_driver->rx_byte, 1) == HAL_OK);
+    return uart_driver_start(uart_driver);
+}
+
+/**
+ * @brief Start reception on a driver whose rings are already wired.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @return true if reception was started, false otherwise.
+ */
+bool uart_driver_start(uart_driver_t *uart_driver) {
+    if (!uart_driver_register(uart_driver)) {
+        return false;
+    }
+
+    // The cycle counter times tx_busy and the interrupts for the stats
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    uart_driver->stats_tick = HAL_GetTick();
+
+    // The register handler moves every byte itself, so it never uses the DMA streams
+    if ((uart_driver->huart->hdmatx == NULL) || (uart_driver->backend == UART_DRIVER_BACKEND_REGISTER)) {
+        uart_driver->tx_mode = UART_DRIVER_TX_MODE_IT;
+    }
+    if ((uart_driver->huart->hdmarx == NULL) || (uart_driver->backend == UART_DRIVER_BACKEND_REGISTER)) {
+        uart_driver->rx_mode = UART_DRIVER_RX_MODE_IT;
+    }
+
+    if (uart_driver->rx_mode == UART_DRIVER_RX_MODE_DMA) {
+        // The stream overwrites unread bytes instead of waiting, which only the overwrite policy models
+        (void) ring_buffer_set_policy(&uart_driver->ring_buffer_rx, RING_BUFFER_POLICY_OVERWRITE_OLDEST);
+    }
+
+    return uart_driver_start_rx(uart_driver);
+}
+
+/**
+ * @brief Register a driver for interrupt dispatch by USART instance.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @return true if registered, false otherwise.
+ */
+bool uart_driver_register(uart_driver_t *uart_driver) {
+    if ((uart_driver == NULL) || (uart_driver->huart == NULL) || (uart_driver->huart->Instance == NULL)) {
+        return false;
+    }
+
+    uart_driver_t **slot = &uart_driver_registry[UART_DRIVER_SLOT(uart_driver->huart->Instance)];
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    bool registered = (*slot == NULL) || (*slot == uart_driver);
+    if (registered) {
+        *slot = uart_driver;
+    }
+
+    __set_PRIMASK(primask);
+    return registered;
+}
+
+/**
+ * @brief Find the driver registered for a USART instance.
+ *
+ * @param instance USART registers.
+ * @return Driver, or NULL if none is registered.
+ */
+uart_driver_t *uart_driver_lookup(const USART_TypeDef *instance) {
+    uart_driver_t *uart_driver = uart_driver_registry[UART_DRIVER_SLOT(instance)];
+
+    if ((uart_driver == NULL) || (uart_driver->huart->Instance != instance)) {
+        return NULL;
+    }
+    return uart_driver;
+}
+
+/**
+ * @brief Select interrupt or DMA transmission.
+ *
+ * Only switches while the transmitter is idle, so a transfer in flight is
+ * always completed by the mode that started it.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param mode New TX mode.
+ * @return true if switched, false otherwise.
+ */
+bool uart_driver_set_tx_mode(uart_driver_t *uart_driver, uart_driver_tx_mode_t mode) {
+    if ((uart_driver == NULL) || (uart_driver->huart == NULL) || (mode > UART_DRIVER_TX_MODE_DMA) ||
+        ((mode == UART_DRIVER_TX_MODE_DMA) &&
+         ((uart_driver->huart->hdmatx == NULL) || (uart_driver->backend == UART_DRIVER_BACKEND_REGISTER)))) {
+        return false;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    bool idle = !uart_driver->tx_busy;
+    if (idle) {
+        uart_driver->tx_mode = mode;
+    }
+
+    __set_PRIMASK(primask);
+    return idle;
+}
+
+/**
+ * @brief Copy the interrupt cost measured so far.
+ *
+ * The counters are updated by interrupts, so they are copied with
+ * interrupts masked to get one consistent snapshot.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @param profile Pointer to store the measurement.
+ * @return true if copied, false otherwise.
+ */
+bool uart_driver_get_profile(uart_driver_t *uart_driver, uart_driver_profile_t *profile) {
+    if ((uart_driver == NULL) || (profile == NULL)) {
+        return false;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    *profile = uart_driver->profile;
+    __set_PRIMASK(primask);
+    return true;
+}
+
+/**
+ * @brief Clear the interrupt cost measurement.
+ *
+ * @param uart_driver Pointer to uart_driver_t structure.
+ * @return true if cleared, false otherwise.
+ */
+bool uart_driver_reset_profile(uart_driver_t *uart_driver) {
+    if (uart_driver == NULL) {
+        return false;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uart_driver->profile = (uart_driver_profile_t) { 0 };
+    __set_PRIMASK(primask);
+    return true;
 }
@@ -0,0 +1,161 @@
+/**
+ * @file element_ring.c
+ * @brief Fixed element-size ring buffer for embedded systems.
+ *
+ * Implements a lock-free single-producer/single-consumer queue of whole
+ * elements, with bulk enqueue/dequeue.
+ *
+ * @author Santiago Rincon
+ * @date 2026
+ */
+
+#include "element_ring.h"
+
+#include <string.h>
+
+/**
+ * @brief Loads an index written by the other side of the ring.
+ */
+#define ELEMENT_RING_LOAD_ACQUIRE(index)            __atomic_load_n(&(index), __ATOMIC_ACQUIRE)
+
+/**
+ * @brief Publishes an index owned by this side of the ring.
+ */
+#define ELEMENT_RING_STORE_RELEASE(index, value)    __atomic_store_n(&(index), (value), __ATOMIC_RELEASE)
+
+/**
+ * @brief Converts an index in [0, 2 * capacity) into an element slot.
+ */
+static inline size_t element_ring_slot(const element_ring_t *er, size_t index) {
+    return (index < er->capacity) ? index : (index - er->capacity);
+}
+
+/**
+ * @brief Advances an index by up to capacity elements.
+ */
+static inline size_t element_ring_advance(const element_ring_t *er, size_t index, size_t count) {
+    index += count;
+    return (index >= (2U * er->capacity)) ? (index - (2U * er->capacity)) : index;
+}
+
+/**
+ * @brief Number of elements between the tail and head indices.
+ */
+static inline size_t element_ring_used(const element_ring_t *er, size_t head, size_t tail) {
+    return (head >= tail) ? (head - tail) : ((2U * er->capacity) + head - tail);
+}
+
+bool element_ring_init(element_ring_t *er, void *buf, size_t element_size, size_t element_count) {
+    if ((er == NULL) || (buf == NULL) || (element_size == 0U) || (element_count == 0U) ||
+        (element_count > (SIZE_MAX / 2U)) || (element_count > (SIZE_MAX / element_size))) {
+        return false;
+    }
+    er->buffer = (uint8_t *)buf;
+    er->capacity = element_count;
+    er->element_size = element_size;
+    return element_ring_reset(er);
+}
+
+bool element_ring_push(element_ring_t *er, const void *element) {
+    return (element_ring_write(er, element, 1U) == 1U);
+}
+
+bool element_ring_pop(element_ring_t *er, void *element) {
+    return (element_ring_read(er, element, 1U) == 1U);
+}
+
+size_t element_ring_write(element_ring_t *er, const void *elements, size_t count) {
+    if ((er == NULL) || (elements == NULL)) {
+        return 0U;
+    }
+
+    size_t head = er->head;
+    size_t tail = ELEMENT_RING_LOAD_ACQUIRE(er->tail);
+    size_t free_slots = er->capacity - element_ring_used(er, head, tail);
+
+    if (count > free_slots) {
+        count = free_slots;
+    }
+    if (count == 0U) {
+        return 0U;
+    }
+
+    size_t slot = element_ring_slot(er, head);
+    size_t first_segment = er->capacity - slot;
+    if (first_segment > count) {
+        first_segment = count;
+    }
+
+    const uint8_t *src = (const uint8_t *)elements;
+    memcpy(&er->buffer[slot * er->element_size], src, first_segment * er->element_size);
+    memcpy(er->buffer, &src[first_segment * er->element_size], (count - first_segment) * er->element_size);
+
+    ELEMENT_RING_STORE_RELEASE(er->head, element_ring_advance(er, head, count));
+    return count;
+}
+
+size_t element_ring_read(element_ring_t *er, void *elements, size_t count) {
+    if ((er == NULL) || (elements == NULL)) {
+        return 0U;
+    }
+
+    size_t tail = er->tail;
+    size_t head = ELEMENT_RING_LOAD_ACQUIRE(er->head);
+    size_t available = element_ring_used(er, head, tail);
+
+    if (count > available) {
+        count = available;
+    }
+    if (count == 0U) {
+        return 0U;
+    }
+
+    size_t slot = element_ring_slot(er, tail);
+    size_t first_segment = er->capacity - slot;
+    if (first_segment > count) {
+        first_segment = count;
+    }
+
+    uint8_t *dst = (uint8_t *)elements;
+    memcpy(dst, &er->buffer[slot * er->element_size], first_segment * er->element_size);
+    memcpy(&dst[first_segment * er->element_size], er->buffer, (count - first_segment) * er->element_size);
+
+    ELEMENT_RING_STORE_RELEASE(er->tail, element_ring_advance(er, tail, count));
+    return count;
+}
+
+bool element_ring_is_empty(element_ring_t *er) {
+    if (er == NULL) {
+        return false;
+    }
+    return (ELEMENT_RING_LOAD_ACQUIRE(er->head) == ELEMENT_RING_LOAD_ACQUIRE(er->tail));
+}
+
+bool element_ring_reset(element_ring_t *er) {
+    if (er == NULL) {
+        return false;
+    }
+
+    ELEMENT_RING_STORE_RELEASE(er->head, 0U);
+    ELEMENT_RING_STORE_RELEASE(er->tail, 0U);
+    return true;
+}
+
+size_t element_ring_get_capacity(element_ring_t *er) {
+    if (er == NULL) {
+        return 0U;
+    }
+
+    return er->capacity;
+}
+
+size_t element_ring_get_count(element_ring_t *er) {
+    if (er == NULL) {
+        return 0U;
+    }
+
+    size_t tail = ELEMENT_RING_LOAD_ACQUIRE(er->tail);
+    size_t head = ELEMENT_RING_LOAD_ACQUIRE(er->head);
+
+    return element_ring_used(er, head, tail);
+}
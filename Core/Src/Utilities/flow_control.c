@@ -0,0 +1,41 @@
+/**
+ * @file flow_control.c
+ * @brief Watermark hysteresis for receive flow control.
+ *
+ * @author Santiago Rincon
+ * @date 2026
+ */
+
+#include "flow_control.h"
+
+bool flow_control_init(flow_control_t *fc, size_t low_water, size_t high_water) {
+    if ((fc == NULL) || (low_water >= high_water)) {
+        return false;
+    }
+    fc->high_water = high_water;
+    fc->low_water = low_water;
+    fc->stopped = false;
+    fc->stop_count = 0U;
+    return true;
+}
+
+bool flow_control_on_produce(flow_control_t *fc, size_t level) {
+    if ((fc == NULL) || fc->stopped || (level < fc->high_water)) {
+        return false;
+    }
+    fc->stopped = true;
+    fc->stop_count++;
+    return true;
+}
+
+bool flow_control_on_consume(flow_control_t *fc, size_t level) {
+    if ((fc == NULL) || !fc->stopped || (level > fc->low_water)) {
+        return false;
+    }
+    fc->stopped = false;
+    return true;
+}
+
+bool flow_control_is_stopped(const flow_control_t *fc) {
+    return (fc != NULL) && fc->stopped;
+}
@@ -0,0 +1,140 @@
+/**
+ * @file record_queue.c
+ * @brief Variable-length record queue built on the byte ring buffer.
+ *
+ * Implements length-prefixed records that are kept contiguous in ring
+ * memory by padding up to the wrap point when needed.
+ *
+ * @author Santiago Rincon
+ * @date 2026
+ */
+
+#include "record_queue.h"
+
+#include <string.h>
+
+/**
+ * @brief Length prefix value marking padding up to the end of the buffer.
+ */
+#define RECORD_QUEUE_PADDING    (0xFFFFU)
+
+bool record_queue_init(record_queue_t *rq, uint8_t *buf, size_t size) {
+    if ((rq == NULL) || (size < RECORD_QUEUE_HEADER_SIZE)) {
+        return false;
+    }
+
+    bool initialized = RING_BUFFER_IS_POW2(size) ? ring_buffer_init_pow2(&rq->ring, buf, size)
+                                                 : ring_buffer_init(&rq->ring, buf, size);
+
+    return initialized && ring_buffer_set_policy(&rq->ring, RING_BUFFER_POLICY_REJECT);
+}
+
+bool record_queue_push(record_queue_t *rq, const void *record, size_t length) {
+    if ((rq == NULL) || ((record == NULL) && (length > 0U)) || (length > RECORD_QUEUE_MAX_RECORD)) {
+        return false;
+    }
+
+    size_t needed = RECORD_QUEUE_HEADER_SIZE + length;
+    uint8_t *region;
+    size_t region_size = ring_buffer_write_acquire(&rq->ring, &region);
+
+    if (region_size < needed) {
+        // Pad to the wrap point only if the record then fits at the start of the buffer
+        size_t free_space = ring_buffer_get_capacity(&rq->ring) - ring_buffer_get_count(&rq->ring);
+        bool reaches_end = ((region + region_size) == (rq->ring.buffer + rq->ring.capacity));
+
+        if ((region_size == 0U) || !reaches_end || ((free_space - region_size) < needed)) {
+            return false;
+        }
+
+        if (region_size >= RECORD_QUEUE_HEADER_SIZE) {
+            uint16_t padding = RECORD_QUEUE_PADDING;
+            memcpy(region, &padding, RECORD_QUEUE_HEADER_SIZE);
+        }
+        (void) ring_buffer_write_commit(&rq->ring, region_size);
+
+        region_size = ring_buffer_write_acquire(&rq->ring, &region);
+        if (region_size < needed) {
+            return false;
+        }
+    }
+
+    uint16_t header = (uint16_t)length;
+    memcpy(region, &header, RECORD_QUEUE_HEADER_SIZE);
+    if (length > 0U) {
+        memcpy(&region[RECORD_QUEUE_HEADER_SIZE], record, length);
+    }
+
+    return ring_buffer_write_commit(&rq->ring, needed);
+}
+
+bool record_queue_peek(record_queue_t *rq, const uint8_t **record, size_t *length) {
+    if ((rq == NULL) || (record == NULL) || (length == NULL)) {
+        return false;
+    }
+
+    for (;;) {
+        uint8_t *region;
+        size_t region_size = ring_buffer_read_acquire(&rq->ring, &region);
+
+        if (region_size == 0U) {
+            return false;
+        }
+
+        // Records never straddle the wrap point, so a short region is padding
+        uint16_t header = RECORD_QUEUE_PADDING;
+        if (region_size >= RECORD_QUEUE_HEADER_SIZE) {
+            memcpy(&header, region, RECORD_QUEUE_HEADER_SIZE);
+        }
+
+        if (header == RECORD_QUEUE_PADDING) {
+            (void) ring_buffer_read_commit(&rq->ring, region_size);
+            continue;
+        }
+
+        *record = &region[RECORD_QUEUE_HEADER_SIZE];
+        *length = header;
+        return true;
+    }
+}
+
+bool record_queue_release(record_queue_t *rq) {
+    const uint8_t *record;
+    size_t length;
+
+    if (!record_queue_peek(rq, &record, &length)) {
+        return false;
+    }
+
+    return ring_buffer_read_commit(&rq->ring, RECORD_QUEUE_HEADER_SIZE + length);
+}
+
+bool record_queue_pop(record_queue_t *rq, void *dst, size_t dst_size, size_t *length) {
+    const uint8_t *record;
+    size_t record_length;
+
+    if ((dst == NULL) || !record_queue_peek(rq, &record, &record_length)) {
+        return false;
+    }
+
+    if (length != NULL) {
+        *length = record_length;
+    }
+    if (record_length > dst_size) {
+        return false;
+    }
+
+    memcpy(dst, record, record_length);
+    return ring_buffer_read_commit(&rq->ring, RECORD_QUEUE_HEADER_SIZE + record_length);
+}
+
+bool record_queue_is_empty(record_queue_t *rq) {
+    if (rq == NULL) {
+        return false;
+    }
+
+    const uint8_t *record;
+    size_t length;
+
+    return !record_queue_peek(rq, &record, &length);
+}
@@ -2,7 +2,7 @@
  * @file ring_buffer.c
  * @brief Generic byte ring buffer for embedded systems.
  *
- * Provides a circular buffer implementation with overwrite-on-full,
+ * Provides a lock-free single-producer/single-consumer (SPSC) circular buffer,
  * and utility functions for buffer management and status.
  *
  * @author Santiago Rincon
@@ -11,56 +11,544 @@
 
 #include "ring_buffer.h"
 
+#include <string.h>
+
+/**
+ * @brief Loads the consumer's own tail index.
+ *
+ * Relaxed is enough: in overwrite mode the producer may move the tail too,
+ * and the consumer then detects it through the compare-and-swap on release.
+ */
+#define RING_BUFFER_LOAD_RELAXED(index)         __atomic_load_n(&(index), __ATOMIC_RELAXED)
+
+/**
+ * @brief Moves the tail index only if nobody else moved it since it was read.
+ *
+ * On failure expected is updated with the current tail value.
+ */
+#define RING_BUFFER_CAS(index, expected, value) \
+    __atomic_compare_exchange_n(&(index), &(expected), (value), false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)
+
+/**
+ * @brief Compare-and-swap used by concurrent producers, which may retry.
+ *
+ * On failure expected is updated with the current value. Compiles to an
+ * LDREX/STREX pair on Cortex-M.
+ */
+#define RING_BUFFER_CAS_WEAK(index, expected, value) \
+    __atomic_compare_exchange_n(&(index), &(expected), (value), true, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)
+
+/**
+ * @brief Converts an index into a buffer offset.
+ *
+ * Power-of-two mode masks the free-running index, otherwise the index lies
+ * in [0, 2 * capacity).
+ */
+static inline size_t ring_buffer_offset(const ring_buffer_t *rb, size_t index) {
+    if (rb->mask != 0U) {
+        return (index & rb->mask);
+    }
+    return (index < rb->capacity) ? index : (index - rb->capacity);
+}
+
+/**
+ * @brief Advances an index by one position.
+ */
+static inline size_t ring_buffer_next(const ring_buffer_t *rb, size_t index) {
+    index++;
+    if (rb->mask != 0U) {
+        return index;
+    }
+    return (index == (2U * rb->capacity)) ? 0U : index;
+}
+
+/**
+ * @brief Advances an index by up to capacity positions.
+ */
+static inline size_t ring_buffer_advance(const ring_buffer_t *rb, size_t index, size_t count) {
+    index += count;
+    if (rb->mask != 0U) {
+        return index;
+    }
+    return (index >= (2U * rb->capacity)) ? (index - (2U * rb->capacity)) : index;
+}
+
+/**
+ * @brief Number of bytes between the tail and head indices.
+ */
+static inline size_t ring_buffer_used(const ring_buffer_t *rb, size_t head, size_t tail) {
+    if (rb->mask != 0U) {
+        return (head - tail);
+    }
+    return (head >= tail) ? (head - tail) : ((2U * rb->capacity) + head - tail);
+}
+
+/**
+ * @brief Records the fill level reached by the producer.
+ */
+static inline void ring_buffer_note_level(ring_buffer_t *rb, size_t level) {
+    if (level > rb->high_water) {
+        rb->high_water = level;
+    }
+}
+
+/**
+ * @brief Makes room for up to length bytes according to the overflow policy.
+ *
+ * Producer side. In overwrite mode the oldest unread bytes are discarded by
+ * moving the tail with a compare-and-swap, so a consumer releasing at the
+ * same time either wins (and frees the space itself) or retries.
+ *
+ * @param rb Pointer to ring buffer structure.
+ * @param head Current head index.
+ * @param length Number of bytes the producer wants to write, at most capacity.
+ * @return Number of bytes the producer may write.
+ */
+static size_t ring_buffer_reserve(ring_buffer_t *rb, size_t head, size_t length) {
+    size_t tail = RING_BUFFER_LOAD_ACQUIRE(rb->tail);
+    size_t used = ring_buffer_used(rb, head, tail);
+    size_t free_space = rb->capacity - used;
+
+    if (length > free_space) {
+        switch (rb->policy) {
+            case RING_BUFFER_POLICY_OVERWRITE_OLDEST:
+                while (length > free_space) {
+                    size_t excess = length - free_space;
+                    if (RING_BUFFER_CAS(rb->tail, tail, ring_buffer_advance(rb, tail, excess))) {
+                        rb->dropped += excess;
+                        used -= excess;
+                        break;
+                    }
+                    used = ring_buffer_used(rb, head, tail);
+                    free_space = rb->capacity - used;
+                }
+                break;
+
+            case RING_BUFFER_POLICY_DROP_NEWEST:
+                rb->dropped += (length - free_space);
+                length = free_space;
+                break;
+
+            case RING_BUFFER_POLICY_REJECT:
+            default:
+                length = free_space;
+                break;
+        }
+    }
+
+    ring_buffer_note_level(rb, used + length);
+    return length;
+}
+
+/**
+ * @brief Releases length bytes starting at the tail index the consumer read from.
+ *
+ * @param rb Pointer to ring buffer structure.
+ * @param tail Tail index observed before reading the data.
+ * @param length Number of bytes consumed.
+ * @return true if released, false if the producer overwrote the bytes meanwhile.
+ */
+static inline bool ring_buffer_release(ring_buffer_t *rb, size_t tail, size_t length) {
+    size_t new_tail = ring_buffer_advance(rb, tail, length);
+
+    if (rb->policy == RING_BUFFER_POLICY_OVERWRITE_OLDEST) {
+        return RING_BUFFER_CAS(rb->tail, tail, new_tail);
+    }
+
+    RING_BUFFER_STORE_RELEASE(rb->tail, new_tail);
+    return true;
+}
+
+/**
+ * @brief Publishes a head index in multi-producer mode.
+ *
+ * Two producers can race to publish, so the head only ever moves forward.
+ * It is free-running, hence compared through the signed distance.
+ */
+static void ring_buffer_publish(ring_buffer_t *rb, size_t head) {
+    size_t current = RING_BUFFER_LOAD_RELAXED(rb->head);
+
+    while ((ptrdiff_t)(head - current) > 0) {
+        if (RING_BUFFER_CAS_WEAK(rb->head, current, head)) {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Multi-producer write.
+ *
+ * Reserves up to length bytes by moving the reserve index with a
+ * compare-and-swap, copies the data, then adds it to the committed count.
+ * When committed catches up with reserve no other producer is mid-copy, so
+ * everything up to that index is complete and the head is published.
+ * A producer that finishes while another is still copying leaves the
+ * publication to that one, so nobody spins on a preempted producer.
+ *
+ * @param rb Pointer to ring buffer structure.
+ * @param src Pointer to data to write.
+ * @param length Number of bytes to write.
+ * @return Number of bytes stored.
+ */
+static size_t ring_buffer_write_shared(ring_buffer_t *rb, const uint8_t *src, size_t length) {
+    size_t start;
+    size_t count;
+    size_t used;
+
+    for (;;) {
+        // Loaded after the tail, reserve cannot trail it; a start from before the loop could
+        size_t tail = RING_BUFFER_LOAD_ACQUIRE(rb->tail);
+        start = RING_BUFFER_LOAD_ACQUIRE(rb->reserve);
+        if ((ptrdiff_t)(start - tail) < 0) {
+            continue;
+        }
+
+        used = start - tail;
+        count = (used < rb->capacity) ? (rb->capacity - used) : 0U;
+        if (count > length) {
+            count = length;
+        }
+        if (count == 0U) {
+            // Full only if neither index moved since they were read
+            if ((RING_BUFFER_LOAD_ACQUIRE(rb->reserve) == start) && (RING_BUFFER_LOAD_ACQUIRE(rb->tail) == tail)) {
+                break;
+            }
+            continue;
+        }
+        if (RING_BUFFER_CAS_WEAK(rb->reserve, start, start + count)) {
+            break;
+        }
+    }
+
+    if ((count < length) && (rb->policy == RING_BUFFER_POLICY_DROP_NEWEST)) {
+        __atomic_fetch_add(&rb->dropped, length - count, __ATOMIC_RELAXED);
+    }
+    if (count == 0U) {
+        return 0U;
+    }
+
+    size_t level = used + count;
+    size_t high_water = RING_BUFFER_LOAD_RELAXED(rb->high_water);
+    while (level > high_water) {
+        if (RING_BUFFER_CAS_WEAK(rb->high_water, high_water, level)) {
+            break;
+        }
+    }
+
+    size_t offset = start & rb->mask;
+    size_t first_segment = rb->capacity - offset;
+    if (first_segment > count) {
+        first_segment = count;
+    }
+
+    memcpy(&rb->buffer[offset], src, first_segment);
+    memcpy(rb->buffer, &src[first_segment], count - first_segment);
+
+    size_t committed = __atomic_add_fetch(&rb->committed, count, __ATOMIC_ACQ_REL);
+    if (committed == RING_BUFFER_LOAD_ACQUIRE(rb->reserve)) {
+        ring_buffer_publish(rb, committed);
+    }
+
+    return count;
+}
+
 bool ring_buffer_init(ring_buffer_t *rb, uint8_t *buf, size_t size) {
-    if ((rb == NULL) || (buf == NULL) || (size == 0)) {
+    if ((rb == NULL) || (buf == NULL) || (size == 0) || (size > (SIZE_MAX / 2U))) {
         return false;
     }
     rb->buffer = buf;
     rb->capacity = size;
+    rb->mask = 0U;
+    rb->policy = RING_BUFFER_POLICY_DROP_NEWEST;
+    rb->multi_producer = false;
+    (void) ring_buffer_reset_stats(rb);
     return ring_buffer_reset(rb);
 }
 
-bool ring_buffer_push(ring_buffer_t *rb, uint8_t data) {
+bool ring_buffer_init_pow2(ring_buffer_t *rb, uint8_t *buf, size_t size) {
+    if ((rb == NULL) || (buf == NULL) || !RING_BUFFER_IS_POW2(size) || (size > (SIZE_MAX / 2U))) {
+        return false;
+    }
+    rb->buffer = buf;
+    rb->capacity = size;
+    rb->mask = size - 1U;
+    rb->policy = RING_BUFFER_POLICY_DROP_NEWEST;
+    rb->multi_producer = false;
+    (void) ring_buffer_reset_stats(rb);
+    return ring_buffer_reset(rb);
+}
+
+bool ring_buffer_set_policy(ring_buffer_t *rb, ring_buffer_policy_t policy) {
+    if ((rb == NULL) || (policy > RING_BUFFER_POLICY_REJECT) ||
+        (rb->multi_producer && (policy == RING_BUFFER_POLICY_OVERWRITE_OLDEST))) {
+        return false;
+    }
+
+    rb->policy = policy;
+    return true;
+}
+
+bool ring_buffer_set_multi_producer(ring_buffer_t *rb, bool enable) {
     if (rb == NULL) {
         return false;
     }
 
-    rb->buffer[rb->head] = data;
-    rb->head = (rb->head + 1) % rb->capacity;
+    if (enable && ((rb->mask == 0U) || (rb->policy == RING_BUFFER_POLICY_OVERWRITE_OLDEST))) {
+        return false;
+    }
+
+    rb->reserve = rb->head;
+    rb->committed = rb->head;
+    rb->multi_producer = enable;
+    return true;
+}
+
+bool ring_buffer_push(ring_buffer_t *rb, uint8_t data) {
+    if (rb == NULL) {
+        return false;
+    }
 
-    if (rb->full) {
-        rb->tail = (rb->tail + 1) % rb->capacity;
+    if (rb->multi_producer) {
+        return (ring_buffer_write_shared(rb, &data, 1U) == 1U);
     }
 
-    if (rb->head == rb->tail) {
-        rb->full = true;
+    size_t head = rb->head;
+
+    if (ring_buffer_reserve(rb, head, 1U) == 0U) {
+        return false;
     }
+
+    rb->buffer[ring_buffer_offset(rb, head)] = data;
+    RING_BUFFER_STORE_RELEASE(rb->head, ring_buffer_next(rb, head));
     return true;
 }
 
 bool ring_buffer_pop(ring_buffer_t *rb, uint8_t *data) {
-    if ((rb == NULL) || (data == NULL) || ring_buffer_is_empty(rb)) {
+    if ((rb == NULL) || (data == NULL)) {
         return false;
     }
 
-    *data = rb->buffer[rb->tail];
-    rb->tail = (rb->tail + 1) % rb->capacity;
-    rb->full = false;
+    for (;;) {
+        size_t tail = RING_BUFFER_LOAD_RELAXED(rb->tail);
+        size_t head = RING_BUFFER_LOAD_ACQUIRE(rb->head);
+
+        if (head == tail) {
+            return false;
+        }
+
+        uint8_t value = rb->buffer[ring_buffer_offset(rb, tail)];
+        if (ring_buffer_release(rb, tail, 1U)) {
+            *data = value;
+            return true;
+        }
+    }
+}
+
+size_t ring_buffer_write(ring_buffer_t *rb, const uint8_t *src, size_t length) {
+    if ((rb == NULL) || (src == NULL)) {
+        return 0U;
+    }
+
+    if (rb->multi_producer) {
+        return ring_buffer_write_shared(rb, src, length);
+    }
+
+    size_t requested = length;
+
+    // Only the newest capacity bytes can survive an oversized overwrite
+    if ((rb->policy == RING_BUFFER_POLICY_OVERWRITE_OLDEST) && (length > rb->capacity)) {
+        rb->dropped += (length - rb->capacity);
+        src = &src[length - rb->capacity];
+        length = rb->capacity;
+    }
+
+    size_t head = rb->head;
+    length = ring_buffer_reserve(rb, head, length);
+    if (length == 0U) {
+        return 0U;
+    }
+
+    size_t offset = ring_buffer_offset(rb, head);
+    size_t first_segment = rb->capacity - offset;
+    if (first_segment > length) {
+        first_segment = length;
+    }
+
+    memcpy(&rb->buffer[offset], src, first_segment);
+    memcpy(rb->buffer, &src[first_segment], length - first_segment);
+
+    RING_BUFFER_STORE_RELEASE(rb->head, ring_buffer_advance(rb, head, length));
+    return (rb->policy == RING_BUFFER_POLICY_OVERWRITE_OLDEST) ? requested : length;
+}
+
+size_t ring_buffer_read(ring_buffer_t *rb, uint8_t *dst, size_t length) {
+    if ((rb == NULL) || (dst == NULL)) {
+        return 0U;
+    }
+
+    for (;;) {
+        size_t tail = RING_BUFFER_LOAD_RELAXED(rb->tail);
+        size_t head = RING_BUFFER_LOAD_ACQUIRE(rb->head);
+        size_t available = ring_buffer_used(rb, head, tail);
+        size_t count = (length < available) ? length : available;
+
+        if (count == 0U) {
+            return 0U;
+        }
+
+        size_t offset = ring_buffer_offset(rb, tail);
+        size_t first_segment = rb->capacity - offset;
+        if (first_segment > count) {
+            first_segment = count;
+        }
+
+        memcpy(dst, &rb->buffer[offset], first_segment);
+        memcpy(&dst[first_segment], rb->buffer, count - first_segment);
+
+        if (ring_buffer_release(rb, tail, count)) {
+            return count;
+        }
+    }
+}
+
+size_t ring_buffer_write_acquire(ring_buffer_t *rb, uint8_t **region) {
+    if ((rb == NULL) || (region == NULL) || rb->multi_producer) {
+        return 0U;
+    }
+
+    size_t head = rb->head;
+    size_t tail = RING_BUFFER_LOAD_ACQUIRE(rb->tail);
+    size_t free_space = rb->capacity - ring_buffer_used(rb, head, tail);
+    size_t offset = ring_buffer_offset(rb, head);
+    size_t contiguous = rb->capacity - offset;
+
+    *region = &rb->buffer[offset];
+    return (contiguous < free_space) ? contiguous : free_space;
+}
+
+bool ring_buffer_write_commit(ring_buffer_t *rb, size_t length) {
+    if ((rb == NULL) || rb->multi_producer) {
+        return false;
+    }
+
+    size_t head = rb->head;
+    size_t tail = RING_BUFFER_LOAD_ACQUIRE(rb->tail);
+    size_t used = ring_buffer_used(rb, head, tail);
+
+    if (length > (rb->capacity - used)) {
+        return false;
+    }
+
+    RING_BUFFER_STORE_RELEASE(rb->head, ring_buffer_advance(rb, head, length));
+    ring_buffer_note_level(rb, used + length);
     return true;
 }
 
+bool ring_buffer_write_advance(ring_buffer_t *rb, size_t length) {
+    if ((rb == NULL) || rb->multi_producer || (length > rb->capacity) ||
+        (rb->policy != RING_BUFFER_POLICY_OVERWRITE_OLDEST)) {
+        return false;
+    }
+
+    size_t head = rb->head;
+
+    // Always grants length in overwrite mode; the tail moves past what the producer overwrote
+    (void) ring_buffer_reserve(rb, head, length);
+    RING_BUFFER_STORE_RELEASE(rb->head, ring_buffer_advance(rb, head, length));
+    return true;
+}
+
+size_t ring_buffer_trim(ring_buffer_t *rb, size_t count) {
+    if (rb == NULL) {
+        return 0U;
+    }
+
+    size_t head = RING_BUFFER_LOAD_ACQUIRE(rb->head);
+    size_t tail = RING_BUFFER_LOAD_ACQUIRE(rb->tail);
+    size_t used = ring_buffer_used(rb, head, tail);
+
+    while (used > count) {
+        size_t excess = used - count;
+        if (RING_BUFFER_CAS(rb->tail, tail, ring_buffer_advance(rb, tail, excess))) {
+            rb->dropped += excess;
+            return excess;
+        }
+        used = ring_buffer_used(rb, head, tail);
+    }
+    return 0U;
+}
+
+size_t ring_buffer_read_acquire(ring_buffer_t *rb, uint8_t **region) {
+    if ((rb == NULL) || (region == NULL)) {
+        return 0U;
+    }
+
+    size_t tail = RING_BUFFER_LOAD_RELAXED(rb->tail);
+    size_t head = RING_BUFFER_LOAD_ACQUIRE(rb->head);
+    size_t available = ring_buffer_used(rb, head, tail);
+    size_t offset = ring_buffer_offset(rb, tail);
+    size_t contiguous = rb->capacity - offset;
+
+    *region = &rb->buffer[offset];
+    return (contiguous < available) ? contiguous : available;
+}
+
+bool ring_buffer_read_commit(ring_buffer_t *rb, size_t length) {
+    if (rb == NULL) {
+        return false;
+    }
+
+    size_t tail = RING_BUFFER_LOAD_RELAXED(rb->tail);
+    size_t head = RING_BUFFER_LOAD_ACQUIRE(rb->head);
+
+    if (length > ring_buffer_used(rb, head, tail)) {
+        return false;
+    }
+
+    return ring_buffer_release(rb, tail, length);
+}
+
+bool ring_buffer_find(ring_buffer_t *rb, uint8_t value, size_t *position) {
+    if ((rb == NULL) || (position == NULL)) {
+        return false;
+    }
+
+    size_t tail = RING_BUFFER_LOAD_RELAXED(rb->tail);
+    size_t head = RING_BUFFER_LOAD_ACQUIRE(rb->head);
+    size_t available = ring_buffer_used(rb, head, tail);
+    size_t offset = ring_buffer_offset(rb, tail);
+    size_t first_segment = rb->capacity - offset;
+    if (first_segment > available) {
+        first_segment = available;
+    }
+
+    const uint8_t *match = memchr(&rb->buffer[offset], value, first_segment);
+    if (match != NULL) {
+        *position = (size_t)(match - &rb->buffer[offset]);
+        return true;
+    }
+
+    match = memchr(rb->buffer, value, available - first_segment);
+    if (match != NULL) {
+        *position = first_segment + (size_t)(match - rb->buffer);
+        return true;
+    }
+
+    return false;
+}
+
 bool ring_buffer_is_empty(ring_buffer_t *rb) {
     if (rb == NULL) {
         return false;
     }
-    return ((rb->full == false) && (rb->head == rb->tail));
+    return (RING_BUFFER_LOAD_ACQUIRE(rb->head) == RING_BUFFER_LOAD_ACQUIRE(rb->tail));
 }
 
 bool ring_buffer_is_full(ring_buffer_t *rb) {
     if (rb == NULL) {
         return false;
     }
-    return (rb->full);
+    return (ring_buffer_get_count(rb) >= rb->capacity);
 }
 
 bool ring_buffer_reset(ring_buffer_t *rb) {
@@ -68,9 +556,10 @@ bool ring_buffer_reset(ring_buffer_t *rb) {
         return false;
     }
 
-    rb->head = 0;
-    rb->tail = 0;
-    rb->full = false;
+    RING_BUFFER_STORE_RELEASE(rb->head, 0U);
+    RING_BUFFER_STORE_RELEASE(rb->tail, 0U);
+    rb->reserve = 0U;
+    rb->committed = 0U;
     return true;
 }
 
@@ -87,16 +576,34 @@ size_t ring_buffer_get_count(ring_buffer_t *rb) {
         return 0U;
     }
 
-    size_t count = 0;
-    if (rb->full) {
-        count = rb->capacity;
+    size_t tail = RING_BUFFER_LOAD_ACQUIRE(rb->tail);
+    size_t head = RING_BUFFER_LOAD_ACQUIRE(rb->head);
 
-    } else if (rb->head >= rb->tail) {
-        count = rb->head - rb->tail;
+    return ring_buffer_used(rb, head, tail);
+}
 
-    } else {
-        count = rb->capacity + rb->head - rb->tail;
+size_t ring_buffer_get_dropped(ring_buffer_t *rb) {
+    if (rb == NULL) {
+        return 0U;
     }
 
-    return count;
+    return rb->dropped;
+}
+
+size_t ring_buffer_get_high_water(ring_buffer_t *rb) {
+    if (rb == NULL) {
+        return 0U;
+    }
+
+    return rb->high_water;
+}
+
+bool ring_buffer_reset_stats(ring_buffer_t *rb) {
+    if (rb == NULL) {
+        return false;
+    }
+
+    rb->dropped = 0U;
+    rb->high_water = 0U;
+    return true;
 }
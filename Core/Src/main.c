@@ -46,6 +46,8 @@
 
 /* Private variables ---------------------------------------------------------*/
 UART_HandleTypeDef huart1;
+DMA_HandleTypeDef hdma_usart1_rx;
+DMA_HandleTypeDef hdma_usart1_tx;
 
 /* USER CODE BEGIN PV */
 
@@ -54,6 +56,7 @@ UART_HandleTypeDef huart1;
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config(void);
 static void MX_GPIO_Init(void);
+static void MX_DMA_Init(void);
 static void MX_USART1_UART_Init(void);
 /* USER CODE BEGIN PFP */
 
@@ -62,10 +65,11 @@ static void MX_USART1_UART_Init(void);
 /* Private user code ---------------------------------------------------------*/
 /* USER CODE BEGIN 0 */
 
-shell_t shell;
+shell_t shell = SHELL_INITIALIZER(shell, &huart1);
 
 int _write(int file, char *ptr, int len) {
-  return uart_driver_send(shell_get_driver_instance(&shell), (uint8_t *)ptr, (size_t)len);
+  // newlib retries a short count and reports 0 as an error
+  return (int)shell_send_bytes(&shell, (uint8_t *)ptr, (size_t)len);
 }
 
 static void heartbeat_handler(void) {
@@ -107,9 +111,16 @@ int main(void)
 
   /* Initialize all configured peripherals */
   MX_GPIO_Init();
+  MX_DMA_Init();
   MX_USART1_UART_Init();
   /* USER CODE BEGIN 2 */
-  shell_init(&shell, &huart1);
+  shell_start(&shell);
+#if SHELL_FLOW_CONTROL
+  uart_driver_set_flow_control(shell_get_driver_instance(&shell), true, SHELL_RTS_GPIO_Port, SHELL_RTS_Pin);
+#endif
+#if SHELL_XON_XOFF
+  uart_driver_set_xon_xoff(shell_get_driver_instance(&shell), true);
+#endif
 
   /* USER CODE END 2 */
 
@@ -204,6 +215,25 @@ static void MX_USART1_UART_Init(void)
 
 }
 
+/**
+  * Enable DMA controller clock
+  */
+static void MX_DMA_Init(void)
+{
+
+  /* DMA controller clock enable */
+  __HAL_RCC_DMA2_CLK_ENABLE();
+
+  /* DMA interrupt init */
+  /* DMA2_Stream2_IRQn interrupt configuration */
+  HAL_NVIC_SetPriority(DMA2_Stream2_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(DMA2_Stream2_IRQn);
+  /* DMA2_Stream7_IRQn interrupt configuration */
+  HAL_NVIC_SetPriority(DMA2_Stream7_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(DMA2_Stream7_IRQn);
+
+}
+
 /**
   * @brief GPIO Initialization Function
   * @param None
@@ -23,7 +23,6 @@
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
 #include "uart_driver.h"
-#include "shell.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -45,8 +44,6 @@
 /* Private variables ---------------------------------------------------------*/
 /* USER CODE BEGIN PV */
 
-extern shell_t shell;
-
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -60,6 +57,8 @@ extern shell_t shell;
 /* USER CODE END 0 */
 
 /* External variables --------------------------------------------------------*/
+extern DMA_HandleTypeDef hdma_usart1_rx;
+extern DMA_HandleTypeDef hdma_usart1_tx;
 extern UART_HandleTypeDef huart1;
 /* USER CODE BEGIN EV */
 
@@ -209,41 +208,98 @@ void SysTick_Handler(void)
 void USART1_IRQHandler(void)
 {
   /* USER CODE BEGIN USART1_IRQn 0 */
+  uint32_t profile_start = uart_driver_profile_begin();
+  uart_driver_t *uart_driver = uart_driver_lookup(USART1);
 
+  if (uart_driver_irq_handler(uart_driver)) {
+    uart_driver_profile_end(uart_driver, profile_start);
+    return;
+  }
   /* USER CODE END USART1_IRQn 0 */
   HAL_UART_IRQHandler(&huart1);
   /* USER CODE BEGIN USART1_IRQn 1 */
-
+  uart_driver_profile_end(uart_driver, profile_start);
   /* USER CODE END USART1_IRQn 1 */
 }
 
+/**
+  * @brief This function handles DMA2 stream2 global interrupt.
+  */
+void DMA2_Stream2_IRQHandler(void)
+{
+  /* USER CODE BEGIN DMA2_Stream2_IRQn 0 */
+  uint32_t profile_start = uart_driver_profile_begin();
+  /* USER CODE END DMA2_Stream2_IRQn 0 */
+  HAL_DMA_IRQHandler(&hdma_usart1_rx);
+  /* USER CODE BEGIN DMA2_Stream2_IRQn 1 */
+  uart_driver_profile_end(uart_driver_lookup(USART1), profile_start);
+  /* USER CODE END DMA2_Stream2_IRQn 1 */
+}
+
+/**
+  * @brief This function handles DMA2 stream7 global interrupt.
+  */
+void DMA2_Stream7_IRQHandler(void)
+{
+  /* USER CODE BEGIN DMA2_Stream7_IRQn 0 */
+  uint32_t profile_start = uart_driver_profile_begin();
+  /* USER CODE END DMA2_Stream7_IRQn 0 */
+  HAL_DMA_IRQHandler(&hdma_usart1_tx);
+  /* USER CODE BEGIN DMA2_Stream7_IRQn 1 */
+  uart_driver_profile_end(uart_driver_lookup(USART1), profile_start);
+  /* USER CODE END DMA2_Stream7_IRQn 1 */
+}
+
 /* USER CODE BEGIN 1 */
 /**
  * @brief HAL UART RX complete callback.
  *
- * Called by HAL when a byte is received. Stores the byte in the RX ring buffer,
- * and restarts reception for the next byte.
+ * Called by HAL when a byte is received. Stores the byte in the RX ring buffer
+ * of the driver registered for the instance, and restarts reception for the
+ * next byte.
  *
  * @param huart Pointer to UART handle.
  */
 void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart) {
-  if (huart->Instance == USART1) {
-    uart_driver_rx_it_callback(shell_get_driver_instance(&shell));
-  }
+  uart_driver_rx_it_callback(uart_driver_lookup(huart->Instance));
+}
+
+/**
+ * @brief HAL UART reception event callback.
+ *
+ * Called by HAL in circular DMA reception on half transfer, transfer complete
+ * and line idle. Publishes the bytes the DMA stream wrote since the last event.
+ *
+ * @param huart Pointer to UART handle.
+ * @param Size Position of the DMA stream in the RX buffer.
+ */
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size) {
+  uart_driver_rx_event_callback(uart_driver_lookup(huart->Instance), Size);
 }
 
 /**
  * @brief HAL UART TX complete callback.
  *
- * Called by HAL when a byte is transmitted. Sends next byte from TX ring buffer if available,
- * otherwise marks TX as not busy.
+ * Called by HAL when a byte (IT mode) or a DMA transfer (DMA mode) has been transmitted.
+ * Sends the next byte or region from the TX ring buffer if available, otherwise marks TX
+ * as not busy.
  *
  * @param huart Pointer to UART handle.
  */
 void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart) {
-  if (huart->Instance == USART1) {
-	  uart_driver_tx_it_callback(shell_get_driver_instance(&shell));
-  }
+  uart_driver_tx_it_callback(uart_driver_lookup(huart->Instance));
+}
+
+/**
+ * @brief HAL UART error callback.
+ *
+ * Called by HAL on overrun, framing, noise, parity and DMA errors. Counts
+ * them and re-arms reception if the error stopped it.
+ *
+ * @param huart Pointer to UART handle.
+ */
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart) {
+  uart_driver_error_callback(uart_driver_lookup(huart->Instance));
 }
 
 /* USER CODE END 1 */
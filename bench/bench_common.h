@@ -0,0 +1,87 @@
+/**
+ * @file bench_common.h
+ * @brief Shared helpers for the host-side benchmarks.
+ *
+ * Provides a monotonic nanosecond clock, a raw cycle counter and a small
+ * deterministic byte sequence generator used to detect lost, duplicated or
+ * reordered bytes on the consumer side.
+ *
+ * @author Santiago Rincon
+ * @date 2026
+ */
+
+#ifndef __BENCH_COMMON_H__
+#define __BENCH_COMMON_H__
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/**
+ * @brief Monotonic wall-clock time in nanoseconds.
+ */
+static inline uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Raw cycle counter.
+ *
+ * TSC on x86, CNTVCT on AArch64, DWT->CYCCNT on Cortex-M (the DWT must
+ * have been enabled by the caller). Falls back to nanoseconds elsewhere.
+ */
+static inline uint64_t bench_cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t value;
+    __asm__ volatile("mrs %0, cntvct_el0" : "=r"(value));
+    return value;
+#elif defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_7M__)
+    return *(volatile uint32_t *)0xE0001004UL;
+#else
+    return bench_now_ns();
+#endif
+}
+
+/**
+ * @brief Deterministic byte stream shared by producer and consumer.
+ *
+ * A 32-bit xorshift keeps the sequence aperiodic over any realistic run, so a
+ * dropped or duplicated byte desynchronises the stream instead of hiding
+ * behind a period of 256.
+ */
+typedef struct {
+    uint32_t state;
+} bench_stream_t;
+
+static inline void bench_stream_init(bench_stream_t *stream, uint32_t seed) {
+    stream->state = (seed != 0U) ? seed : 0x9E3779B9U;
+}
+
+static inline uint8_t bench_stream_next(bench_stream_t *stream) {
+    uint32_t x = stream->state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    stream->state = x;
+    return (uint8_t)(x >> 24);
+}
+
+/**
+ * @brief Prints a throughput line in a uniform format.
+ */
+static inline void bench_report_rate(const char *name, uint64_t items, uint64_t elapsed_ns, const char *unit) {
+    double seconds = (double)elapsed_ns / 1e9;
+    double rate = (seconds > 0.0) ? ((double)items / seconds) : 0.0;
+    printf("%-40s %14llu %-7s %10.3f s %14.0f %s/s\n",
+           name, (unsigned long long)items, unit, seconds, rate, unit);
+}
+
+#endif /* __BENCH_COMMON_H__ */
@@ -0,0 +1,214 @@
+/**
+ * @file bench_queues.c
+ * @brief Multithreaded throughput benchmark for element_ring_t and record_queue_t.
+ *
+ * For several element sizes, one producer thread enqueues numbered records
+ * and one consumer thread dequeues and checks them, reporting records/s:
+ *  - element_ring_t with single push/pop and with bulk write/read batches,
+ *  - record_queue_t with lengths varying between 1 and the element size.
+ *
+ * Build:
+ *   gcc -O2 -pthread -I Core/Inc/Utilities bench/bench_queues.c \
+ *       Core/Src/Utilities/element_ring.c Core/Src/Utilities/record_queue.c \
+ *       Core/Src/Utilities/ring_buffer.c -o bench_queues
+ *
+ * Usage: bench_queues [records]
+ *
+ * @author Santiago Rincon
+ * @date 2026
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench_common.h"
+#include "element_ring.h"
+#include "record_queue.h"
+
+#define BENCH_DEFAULT_RECORDS   (2000000ULL)    /**< Records moved per run */
+#define BENCH_RING_ELEMENTS     (64U)           /**< Element ring depth */
+#define BENCH_QUEUE_BYTES       (4096U)         /**< Record queue buffer size */
+#define BENCH_BATCH             (8U)            /**< Elements per bulk call */
+#define BENCH_MAX_ELEMENT       (128U)          /**< Largest element size tested */
+
+typedef enum {
+    BENCH_ELEMENT_SINGLE,
+    BENCH_ELEMENT_BULK,
+    BENCH_RECORD
+} bench_kind_t;
+
+typedef struct {
+    bench_kind_t kind;
+    element_ring_t ring;
+    record_queue_t queue;
+    size_t element_size;
+    uint64_t records;
+    uint64_t errors;
+} bench_ctx_t;
+
+/**
+ * @brief Fills a record with its sequence number followed by a derived pattern.
+ */
+static void fill_record(uint8_t *record, size_t length, uint32_t sequence) {
+    for (size_t i = 0; i < length; i++) {
+        record[i] = (uint8_t)(sequence + (i * 31U));
+    }
+    if (length >= sizeof(sequence)) {
+        memcpy(record, &sequence, sizeof(sequence));
+    }
+}
+
+static bool check_record(const uint8_t *record, size_t length, uint32_t sequence) {
+    uint8_t expected[BENCH_MAX_ELEMENT];
+    fill_record(expected, length, sequence);
+    return (memcmp(record, expected, length) == 0);
+}
+
+/**
+ * @brief Record length for a sequence number, varying between 1 and max.
+ */
+static size_t record_length(uint32_t sequence, size_t max) {
+    return 1U + ((sequence * 2654435761U) % max);
+}
+
+static void *producer_thread(void *arg) {
+    bench_ctx_t *ctx = (bench_ctx_t *)arg;
+    uint8_t batch[BENCH_BATCH * BENCH_MAX_ELEMENT];
+
+    for (uint64_t sent = 0; sent < ctx->records;) {
+        uint32_t sequence = (uint32_t)sent;
+        switch (ctx->kind) {
+            case BENCH_ELEMENT_SINGLE:
+                fill_record(batch, ctx->element_size, sequence);
+                while (!element_ring_push(&ctx->ring, batch)) {
+                    sched_yield();
+                }
+                sent++;
+                break;
+
+            case BENCH_ELEMENT_BULK: {
+                size_t count = ((ctx->records - sent) < BENCH_BATCH) ? (size_t)(ctx->records - sent) : BENCH_BATCH;
+                for (size_t i = 0; i < count; i++) {
+                    fill_record(&batch[i * ctx->element_size], ctx->element_size, sequence + (uint32_t)i);
+                }
+                size_t written = 0;
+                while (written < count) {
+                    size_t step = element_ring_write(&ctx->ring, &batch[written * ctx->element_size], count - written);
+                    if (step == 0U) {
+                        sched_yield();
+                    }
+                    written += step;
+                }
+                sent += count;
+                break;
+            }
+
+            case BENCH_RECORD:
+            default: {
+                size_t length = record_length(sequence, ctx->element_size);
+                fill_record(batch, length, sequence);
+                while (!record_queue_push(&ctx->queue, batch, length)) {
+                    sched_yield();
+                }
+                sent++;
+                break;
+            }
+        }
+    }
+    return NULL;
+}
+
+static void *consumer_thread(void *arg) {
+    bench_ctx_t *ctx = (bench_ctx_t *)arg;
+    uint8_t batch[BENCH_BATCH * BENCH_MAX_ELEMENT];
+
+    for (uint64_t received = 0; received < ctx->records;) {
+        uint32_t sequence = (uint32_t)received;
+        switch (ctx->kind) {
+            case BENCH_ELEMENT_SINGLE:
+                while (!element_ring_pop(&ctx->ring, batch)) {
+                    sched_yield();
+                }
+                ctx->errors += check_record(batch, ctx->element_size, sequence) ? 0U : 1U;
+                received++;
+                break;
+
+            case BENCH_ELEMENT_BULK: {
+                size_t count = element_ring_read(&ctx->ring, batch, BENCH_BATCH);
+                if (count == 0U) {
+                    sched_yield();
+                }
+                for (size_t i = 0; i < count; i++) {
+                    ctx->errors += check_record(&batch[i * ctx->element_size], ctx->element_size, sequence + (uint32_t)i) ? 0U : 1U;
+                }
+                received += count;
+                break;
+            }
+
+            case BENCH_RECORD:
+            default: {
+                const uint8_t *record;
+                size_t length;
+                while (!record_queue_peek(&ctx->queue, &record, &length)) {
+                    sched_yield();
+                }
+                if ((length != record_length(sequence, ctx->element_size)) || !check_record(record, length, sequence)) {
+                    ctx->errors++;
+                }
+                (void) record_queue_release(&ctx->queue);
+                received++;
+                break;
+            }
+        }
+    }
+    return NULL;
+}
+
+static bool run(bench_kind_t kind, size_t element_size, uint64_t records) {
+    static uint8_t storage[BENCH_RING_ELEMENTS * BENCH_MAX_ELEMENT];
+    static uint8_t queue_storage[BENCH_QUEUE_BYTES];
+    static const char *names[] = { "element_ring push/pop", "element_ring write/read x8", "record_queue (1..size)" };
+
+    bench_ctx_t ctx = { .kind = kind, .element_size = element_size, .records = records };
+    element_ring_init(&ctx.ring, storage, element_size, BENCH_RING_ELEMENTS);
+    record_queue_init(&ctx.queue, queue_storage, sizeof(queue_storage));
+
+    pthread_t producer;
+    pthread_t consumer;
+    uint64_t start = bench_now_ns();
+    pthread_create(&consumer, NULL, consumer_thread, &ctx);
+    pthread_create(&producer, NULL, producer_thread, &ctx);
+    pthread_join(producer, NULL);
+    pthread_join(consumer, NULL);
+    uint64_t elapsed = bench_now_ns() - start;
+
+    char name[64];
+    snprintf(name, sizeof(name), "%s, %3zu B", names[kind], element_size);
+    bench_report_rate(name, records, elapsed, "records");
+
+    if (ctx.errors != 0U) {
+        printf("FAIL: %llu corrupted or out-of-order records\n", (unsigned long long)ctx.errors);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    uint64_t records = (argc > 1) ? strtoull(argv[1], NULL, 0) : BENCH_DEFAULT_RECORDS;
+    static const size_t sizes[] = { 4U, 8U, 16U, 32U, 64U, 128U };
+    bool ok = true;
+
+    for (size_t kind = BENCH_ELEMENT_SINGLE; kind <= BENCH_RECORD; kind++) {
+        for (size_t i = 0; i < (sizeof(sizes) / sizeof(sizes[0])); i++) {
+            ok = run((bench_kind_t)kind, sizes[i], records) && ok;
+        }
+    }
+
+    printf("%s\n", ok ? "OK: all records intact and in order" : "FAIL");
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,171 @@
+/**
+ * @file bench_ring_buffer_index.c
+ * @brief Cycle-count comparison of ring buffer index wrapping schemes.
+ *
+ * Pushes and pops bytes through three single-threaded rings of the same
+ * capacity and reports cycles per byte:
+ *  - the original modulo implementation (head/tail/full flag, two '%' per op),
+ *  - ring_buffer_init() with indices in [0, 2 * capacity),
+ *  - ring_buffer_init_pow2() with free-running masked indices.
+ *
+ * The capacity is read through a volatile so the compiler cannot turn the
+ * modulo into a mask, which matches what the firmware sees across calls.
+ *
+ * Build:
+ *   gcc -O2 -I Core/Inc/Utilities bench/bench_ring_buffer_index.c \
+ *       Core/Src/Utilities/ring_buffer.c -o bench_ring_buffer_index
+ *
+ * Usage: bench_ring_buffer_index [bytes] [capacity]
+ *
+ * @author Santiago Rincon
+ * @date 2026
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench_common.h"
+#include "ring_buffer.h"
+
+#define BENCH_DEFAULT_BYTES     (50000000ULL)   /**< Bytes moved per scheme */
+#define BENCH_DEFAULT_CAPACITY  (256U)          /**< Same size as the UART rings */
+#define BENCH_BURST             (64U)           /**< Bytes pushed before draining */
+
+/**
+ * @brief Original modulo ring buffer, kept verbatim for comparison.
+ */
+typedef struct {
+    uint8_t *buffer;
+    size_t head;
+    size_t tail;
+    size_t capacity;
+    bool full;
+} modulo_ring_t;
+
+static __attribute__((noinline)) bool modulo_push(modulo_ring_t *rb, uint8_t data) {
+    if (rb == NULL) {
+        return false;
+    }
+
+    rb->buffer[rb->head] = data;
+    rb->head = (rb->head + 1) % rb->capacity;
+
+    if (rb->full) {
+        rb->tail = (rb->tail + 1) % rb->capacity;
+    }
+
+    if (rb->head == rb->tail) {
+        rb->full = true;
+    }
+    return true;
+}
+
+static __attribute__((noinline)) bool modulo_is_empty(modulo_ring_t *rb) {
+    if (rb == NULL) {
+        return false;
+    }
+    return ((rb->full == false) && (rb->head == rb->tail));
+}
+
+static __attribute__((noinline)) bool modulo_pop(modulo_ring_t *rb, uint8_t *data) {
+    if ((rb == NULL) || (data == NULL) || modulo_is_empty(rb)) {
+        return false;
+    }
+
+    *data = rb->buffer[rb->tail];
+    rb->tail = (rb->tail + 1) % rb->capacity;
+    rb->full = false;
+    return true;
+}
+
+static void report(const char *name, uint64_t bytes, uint64_t cycles, uint64_t ns, uint32_t checksum) {
+    printf("%-28s %8.2f cycles/byte %8.2f ns/byte  (checksum %08x)\n",
+           name, (double)cycles / (double)bytes, (double)ns / (double)bytes, checksum);
+}
+
+int main(int argc, char **argv) {
+    uint64_t bytes = (argc > 1) ? strtoull(argv[1], NULL, 0) : BENCH_DEFAULT_BYTES;
+    volatile size_t capacity_source = (argc > 2) ? (size_t)strtoul(argv[2], NULL, 0) : BENCH_DEFAULT_CAPACITY;
+    size_t capacity = capacity_source;
+    uint64_t bursts = bytes / BENCH_BURST;
+    bytes = bursts * BENCH_BURST;
+
+    if ((capacity < BENCH_BURST) || !RING_BUFFER_IS_POW2(capacity)) {
+        fprintf(stderr, "capacity must be a power of two >= %u\n", BENCH_BURST);
+        return EXIT_FAILURE;
+    }
+
+    uint8_t *storage = malloc(capacity);
+    if (storage == NULL) {
+        return EXIT_FAILURE;
+    }
+
+    printf("ring buffer index schemes, capacity %zu, %llu bytes\n", capacity, (unsigned long long)bytes);
+
+    /* Original modulo implementation */
+    {
+        modulo_ring_t rb = { .buffer = storage, .capacity = capacity };
+        uint32_t checksum = 0U;
+        uint64_t ns = bench_now_ns();
+        uint64_t cycles = bench_cycles();
+        for (uint64_t burst = 0; burst < bursts; burst++) {
+            for (uint32_t i = 0; i < BENCH_BURST; i++) {
+                modulo_push(&rb, (uint8_t)i);
+            }
+            uint8_t value;
+            while (modulo_pop(&rb, &value)) {
+                checksum += value;
+            }
+        }
+        cycles = bench_cycles() - cycles;
+        ns = bench_now_ns() - ns;
+        report("modulo (original)", bytes, cycles, ns, checksum);
+    }
+
+    /* Mirrored indices, any capacity */
+    {
+        ring_buffer_t rb;
+        ring_buffer_init(&rb, storage, capacity);
+        uint32_t checksum = 0U;
+        uint64_t ns = bench_now_ns();
+        uint64_t cycles = bench_cycles();
+        for (uint64_t burst = 0; burst < bursts; burst++) {
+            for (uint32_t i = 0; i < BENCH_BURST; i++) {
+                ring_buffer_push(&rb, (uint8_t)i);
+            }
+            uint8_t value;
+            while (ring_buffer_pop(&rb, &value)) {
+                checksum += value;
+            }
+        }
+        cycles = bench_cycles() - cycles;
+        ns = bench_now_ns() - ns;
+        report("ring_buffer_init", bytes, cycles, ns, checksum);
+    }
+
+    /* Power-of-two mask */
+    {
+        ring_buffer_t rb;
+        ring_buffer_init_pow2(&rb, storage, capacity);
+        uint32_t checksum = 0U;
+        uint64_t ns = bench_now_ns();
+        uint64_t cycles = bench_cycles();
+        for (uint64_t burst = 0; burst < bursts; burst++) {
+            for (uint32_t i = 0; i < BENCH_BURST; i++) {
+                ring_buffer_push(&rb, (uint8_t)i);
+            }
+            uint8_t value;
+            while (ring_buffer_pop(&rb, &value)) {
+                checksum += value;
+            }
+        }
+        cycles = bench_cycles() - cycles;
+        ns = bench_now_ns() - ns;
+        report("ring_buffer_init_pow2", bytes, cycles, ns, checksum);
+    }
+
+    free(storage);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,164 @@
+/**
+ * @file bench_ring_buffer_inline.c
+ * @brief Checked versus inline fast-path ring buffer push/pop.
+ *
+ * Moves bytes one at a time through a power-of-two ring, the way the UART
+ * RX/TX interrupts do, and reports cycles per byte for:
+ *  - ring_buffer_push()/ring_buffer_pop(), out of line with argument checks,
+ *  - ring_buffer_push_fast()/ring_buffer_pop_fast(), inlined from the header.
+ *
+ * Each variant is also wrapped in a noinline "ISR body" (one push or one
+ * pop). The checked wrappers are tail calls, so compare isr_*_fast against
+ * isr_*_checked plus the ring_buffer_push/pop code they reach:
+ *   nm -S --size-sort bench_ring_buffer_inline | grep -E "isr_|ring_buffer_(push|pop|reserve)"
+ *
+ * Built for a Cortex-M4 target, bench_cycles() reads DWT->CYCCNT, so the
+ * same loop gives core cycles per byte there.
+ *
+ * Build:
+ *   gcc -O2 -I Core/Inc/Utilities bench/bench_ring_buffer_inline.c \
+ *       Core/Src/Utilities/ring_buffer.c -o bench_ring_buffer_inline
+ *
+ * Usage: bench_ring_buffer_inline [bytes] [capacity]
+ *
+ * @author Santiago Rincon
+ * @date 2026
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench_common.h"
+#include "ring_buffer.h"
+
+#define BENCH_DEFAULT_BYTES     (50000000ULL)   /**< Bytes moved per variant */
+#define BENCH_DEFAULT_CAPACITY  (256U)          /**< Same size as the UART rings */
+#define BENCH_BURST             (64U)           /**< Bytes pushed before draining */
+
+__attribute__((noinline)) bool isr_push_checked(ring_buffer_t *rb, uint8_t data) {
+    return ring_buffer_push(rb, data);
+}
+
+__attribute__((noinline)) bool isr_pop_checked(ring_buffer_t *rb, uint8_t *data) {
+    return ring_buffer_pop(rb, data);
+}
+
+__attribute__((noinline)) bool isr_push_fast(ring_buffer_t *rb, uint8_t data) {
+    return ring_buffer_push_fast(rb, data);
+}
+
+__attribute__((noinline)) bool isr_pop_fast(ring_buffer_t *rb, uint8_t *data) {
+    return ring_buffer_pop_fast(rb, data);
+}
+
+static void report(const char *name, uint64_t bytes, uint64_t cycles, uint64_t ns, uint32_t checksum) {
+    printf("%-28s %8.2f cycles/byte %8.2f ns/byte  (checksum %08x)\n",
+           name, (double)cycles / (double)bytes, (double)ns / (double)bytes, checksum);
+}
+
+int main(int argc, char **argv) {
+    uint64_t bytes = (argc > 1) ? strtoull(argv[1], NULL, 0) : BENCH_DEFAULT_BYTES;
+    size_t capacity = (argc > 2) ? (size_t)strtoul(argv[2], NULL, 0) : BENCH_DEFAULT_CAPACITY;
+    uint64_t bursts = bytes / BENCH_BURST;
+    bytes = bursts * BENCH_BURST;
+
+    if ((capacity < BENCH_BURST) || !RING_BUFFER_IS_POW2(capacity)) {
+        fprintf(stderr, "capacity must be a power of two >= %u\n", BENCH_BURST);
+        return EXIT_FAILURE;
+    }
+
+    uint8_t *storage = malloc(capacity);
+    if (storage == NULL) {
+        return EXIT_FAILURE;
+    }
+
+    printf("ring buffer push/pop, capacity %zu, %llu bytes\n", capacity, (unsigned long long)bytes);
+
+    /* Checked, out of line */
+    {
+        ring_buffer_t rb;
+        ring_buffer_init_pow2(&rb, storage, capacity);
+        uint32_t checksum = 0U;
+        uint64_t ns = bench_now_ns();
+        uint64_t cycles = bench_cycles();
+        for (uint64_t burst = 0; burst < bursts; burst++) {
+            for (uint32_t i = 0; i < BENCH_BURST; i++) {
+                ring_buffer_push(&rb, (uint8_t)i);
+            }
+            uint8_t value;
+            while (ring_buffer_pop(&rb, &value)) {
+                checksum += value;
+            }
+        }
+        cycles = bench_cycles() - cycles;
+        ns = bench_now_ns() - ns;
+        report("ring_buffer_push/pop", bytes, cycles, ns, checksum);
+    }
+
+    /* Unchecked, inlined */
+    {
+        ring_buffer_t rb;
+        ring_buffer_init_pow2(&rb, storage, capacity);
+        uint32_t checksum = 0U;
+        uint64_t ns = bench_now_ns();
+        uint64_t cycles = bench_cycles();
+        for (uint64_t burst = 0; burst < bursts; burst++) {
+            for (uint32_t i = 0; i < BENCH_BURST; i++) {
+                ring_buffer_push_fast(&rb, (uint8_t)i);
+            }
+            uint8_t value;
+            while (ring_buffer_pop_fast(&rb, &value)) {
+                checksum += value;
+            }
+        }
+        cycles = bench_cycles() - cycles;
+        ns = bench_now_ns() - ns;
+        report("ring_buffer_push/pop_fast", bytes, cycles, ns, checksum);
+    }
+
+    /* ISR-shaped calls: one byte per call, as in the UART callbacks */
+    {
+        ring_buffer_t rb;
+        ring_buffer_init_pow2(&rb, storage, capacity);
+        uint32_t checksum = 0U;
+        uint64_t ns = bench_now_ns();
+        uint64_t cycles = bench_cycles();
+        for (uint64_t burst = 0; burst < bursts; burst++) {
+            for (uint32_t i = 0; i < BENCH_BURST; i++) {
+                isr_push_checked(&rb, (uint8_t)i);
+            }
+            uint8_t value;
+            while (isr_pop_checked(&rb, &value)) {
+                checksum += value;
+            }
+        }
+        cycles = bench_cycles() - cycles;
+        ns = bench_now_ns() - ns;
+        report("isr_push/pop_checked", bytes, cycles, ns, checksum);
+    }
+
+    {
+        ring_buffer_t rb;
+        ring_buffer_init_pow2(&rb, storage, capacity);
+        uint32_t checksum = 0U;
+        uint64_t ns = bench_now_ns();
+        uint64_t cycles = bench_cycles();
+        for (uint64_t burst = 0; burst < bursts; burst++) {
+            for (uint32_t i = 0; i < BENCH_BURST; i++) {
+                isr_push_fast(&rb, (uint8_t)i);
+            }
+            uint8_t value;
+            while (isr_pop_fast(&rb, &value)) {
+                checksum += value;
+            }
+        }
+        cycles = bench_cycles() - cycles;
+        ns = bench_now_ns() - ns;
+        report("isr_push/pop_fast", bytes, cycles, ns, checksum);
+    }
+
+    free(storage);
+    return EXIT_SUCCESS;
+}
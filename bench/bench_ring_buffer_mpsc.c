@@ -0,0 +1,234 @@
+/**
+ * @file bench_ring_buffer_mpsc.c
+ * @brief Multi-producer contention benchmark for ring_buffer_t.
+ *
+ * N producer threads stand in for ISRs and the main loop logging into the
+ * UART TX ring, and one consumer thread for the TX interrupt. Every
+ * producer writes fixed-size messages tagged with its id and a sequence
+ * number; the consumer checks that each message arrives whole and that
+ * every producer's messages arrive in order with none lost or duplicated.
+ *
+ * Each producer count is run twice: with the lock-free multi-producer mode
+ * (ring_buffer_set_multi_producer()) and with a single-producer ring behind
+ * a mutex, the host stand-in for masking interrupts around the copy.
+ *
+ * A third, paced run keeps one message per producer in flight, so the ring
+ * is never full: with the drop-newest policy every write must succeed and
+ * nothing may be counted as dropped, however the producers interleave.
+ *
+ * Build:
+ *   gcc -O2 -pthread -I Core/Inc/Utilities bench/bench_ring_buffer_mpsc.c \
+ *       Core/Src/Utilities/ring_buffer.c -o bench_ring_buffer_mpsc
+ *
+ * Usage: bench_ring_buffer_mpsc [messages per producer] [max producers] [capacity]
+ *
+ * @author Santiago Rincon
+ * @date 2026
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench_common.h"
+#include "ring_buffer.h"
+
+#define BENCH_DEFAULT_MESSAGES  (2000000ULL)    /**< Messages written by each producer */
+#define BENCH_DEFAULT_PRODUCERS (8U)            /**< Largest producer count tried */
+#define BENCH_DEFAULT_CAPACITY  (256U)          /**< Same size as the UART TX ring */
+#define BENCH_MESSAGE_SIZE      (16U)           /**< Bytes per message, divides the capacity */
+#define BENCH_MAX_PRODUCERS     (64U)           /**< Producer ids fit in one byte */
+#define BENCH_READ_MESSAGES     (8U)            /**< Messages drained per consumer read */
+
+typedef struct {
+    ring_buffer_t *rb;
+    pthread_mutex_t *lock;      /**< NULL for the lock-free mode */
+    bool paced;                 /**< Each producer waits until its message is read */
+    uint64_t messages;
+    unsigned producers;
+    uint64_t partial_writes;    /**< Updated atomically by the producers */
+    uint64_t spurious_full;     /**< Paced writes refused although the ring had room */
+    uint32_t delivered[BENCH_MAX_PRODUCERS]; /**< Messages read per producer, for pacing */
+    uint64_t bad_messages;
+    uint64_t out_of_order;
+} bench_ctx_t;
+
+typedef struct {
+    bench_ctx_t *ctx;
+    uint8_t id;
+} bench_producer_t;
+
+static void message_fill(uint8_t *message, uint8_t id, uint32_t seq) {
+    message[0] = id;
+    memcpy(&message[1], &seq, sizeof(seq));
+    for (uint32_t i = 1U + sizeof(seq); i < BENCH_MESSAGE_SIZE; i++) {
+        message[i] = (uint8_t)((seq * 31U) + id + i);
+    }
+}
+
+static void *producer_thread(void *arg) {
+    bench_producer_t *producer = (bench_producer_t *)arg;
+    bench_ctx_t *ctx = producer->ctx;
+    uint8_t message[BENCH_MESSAGE_SIZE];
+
+    for (uint64_t seq = 0; seq < ctx->messages; seq++) {
+        message_fill(message, producer->id, (uint32_t)seq);
+
+        // Whole messages only: the free space is always a multiple of the message size
+        for (;;) {
+            size_t written;
+            if (ctx->lock != NULL) {
+                pthread_mutex_lock(ctx->lock);
+                written = ring_buffer_write(ctx->rb, message, sizeof(message));
+                pthread_mutex_unlock(ctx->lock);
+            } else {
+                written = ring_buffer_write(ctx->rb, message, sizeof(message));
+            }
+            if (written == sizeof(message)) {
+                break;
+            }
+            if (ctx->paced) {
+                __atomic_fetch_add(&ctx->spurious_full, 1U, __ATOMIC_RELAXED);
+            }
+            if (written != 0U) {
+                __atomic_fetch_add(&ctx->partial_writes, 1U, __ATOMIC_RELAXED);
+                break;
+            }
+            sched_yield(); /* Full, let the consumer run */
+        }
+
+        while (ctx->paced && (__atomic_load_n(&ctx->delivered[producer->id], __ATOMIC_ACQUIRE) <= seq)) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void *consumer_thread(void *arg) {
+    bench_ctx_t *ctx = (bench_ctx_t *)arg;
+    uint8_t chunk[BENCH_MESSAGE_SIZE * BENCH_READ_MESSAGES];
+    uint32_t next_seq[BENCH_MAX_PRODUCERS] = { 0 };
+    uint64_t remaining = ctx->messages * ctx->producers;
+
+    while (remaining > 0U) {
+        size_t count = ring_buffer_read(ctx->rb, chunk, sizeof(chunk));
+        if (count == 0U) {
+            sched_yield(); /* Empty, let the producers run */
+            continue;
+        }
+
+        for (size_t offset = 0; offset < count; offset += BENCH_MESSAGE_SIZE) {
+            uint8_t expected[BENCH_MESSAGE_SIZE];
+            uint8_t id = chunk[offset];
+            uint32_t seq;
+            memcpy(&seq, &chunk[offset + 1U], sizeof(seq));
+
+            if (id >= ctx->producers) {
+                ctx->bad_messages++;
+                continue;
+            }
+            message_fill(expected, id, seq);
+            if (memcmp(expected, &chunk[offset], BENCH_MESSAGE_SIZE) != 0) {
+                ctx->bad_messages++;
+            } else if (seq != next_seq[id]) {
+                ctx->out_of_order++;
+            }
+            next_seq[id] = seq + 1U;
+            __atomic_store_n(&ctx->delivered[id], next_seq[id], __ATOMIC_RELEASE);
+        }
+        remaining -= (count / BENCH_MESSAGE_SIZE);
+    }
+    return NULL;
+}
+
+static bool run(uint8_t *storage, size_t capacity, unsigned producers, uint64_t messages, bool locked, bool paced) {
+    ring_buffer_t rb;
+    pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+    pthread_t consumer;
+    pthread_t threads[BENCH_MAX_PRODUCERS];
+    bench_producer_t args[BENCH_MAX_PRODUCERS];
+
+    ring_buffer_init_pow2(&rb, storage, capacity);
+    ring_buffer_set_policy(&rb, paced ? RING_BUFFER_POLICY_DROP_NEWEST : RING_BUFFER_POLICY_REJECT);
+    if (!locked) {
+        ring_buffer_set_multi_producer(&rb, true);
+    }
+
+    bench_ctx_t ctx = {
+        .rb = &rb,
+        .lock = locked ? &lock : NULL,
+        .paced = paced,
+        .messages = messages,
+        .producers = producers,
+    };
+
+    uint64_t start = bench_now_ns();
+    pthread_create(&consumer, NULL, consumer_thread, &ctx);
+    for (unsigned i = 0; i < producers; i++) {
+        args[i].ctx = &ctx;
+        args[i].id = (uint8_t)i;
+        pthread_create(&threads[i], NULL, producer_thread, &args[i]);
+    }
+    for (unsigned i = 0; i < producers; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    pthread_join(consumer, NULL);
+    uint64_t elapsed = bench_now_ns() - start;
+
+    char name[64];
+    snprintf(name, sizeof(name), "%u producer(s), %s", producers,
+             locked ? "mutex" : (paced ? "lock-free paced" : "lock-free"));
+    bench_report_rate(name, messages * producers, elapsed, "msgs");
+
+    if ((ctx.partial_writes != 0U) || (ctx.bad_messages != 0U) || (ctx.out_of_order != 0U) ||
+        (ctx.spurious_full != 0U) || (paced && (ring_buffer_get_dropped(&rb) != 0U)) || !ring_buffer_is_empty(&rb)) {
+        printf("FAIL: %llu partial, %llu corrupt, %llu out of order, %llu spurious full, %zu dropped, "
+               "%zu bytes left in ring\n",
+               (unsigned long long)ctx.partial_writes, (unsigned long long)ctx.bad_messages,
+               (unsigned long long)ctx.out_of_order, (unsigned long long)ctx.spurious_full,
+               ring_buffer_get_dropped(&rb), ring_buffer_get_count(&rb));
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    uint64_t messages = (argc > 1) ? strtoull(argv[1], NULL, 0) : BENCH_DEFAULT_MESSAGES;
+    unsigned max_producers = (argc > 2) ? (unsigned)strtoul(argv[2], NULL, 0) : BENCH_DEFAULT_PRODUCERS;
+    size_t capacity = (argc > 3) ? (size_t)strtoul(argv[3], NULL, 0) : BENCH_DEFAULT_CAPACITY;
+
+    if (!RING_BUFFER_IS_POW2(capacity) || (capacity < BENCH_MESSAGE_SIZE) ||
+        (max_producers == 0U) || (max_producers > BENCH_MAX_PRODUCERS)) {
+        fprintf(stderr, "capacity must be a power of two >= %u, producers 1..%u\n",
+                BENCH_MESSAGE_SIZE, BENCH_MAX_PRODUCERS);
+        return EXIT_FAILURE;
+    }
+
+    uint8_t *storage = malloc(capacity);
+    if (storage == NULL) {
+        return EXIT_FAILURE;
+    }
+
+    bool ok = true;
+    for (unsigned producers = 1U; producers <= max_producers; producers *= 2U) {
+        ok = run(storage, capacity, producers, messages, false, false) && ok;
+        ok = run(storage, capacity, producers, messages, true, false) && ok;
+        // One message per producer in flight must fit, or the ring could really be full
+        if ((producers * BENCH_MESSAGE_SIZE) <= capacity) {
+            ok = run(storage, capacity, producers, messages / 16U, false, true) && ok;
+        }
+    }
+
+    free(storage);
+
+    if (!ok) {
+        return EXIT_FAILURE;
+    }
+
+    printf("OK: every message whole and in order per producer, no drop while the ring had room\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,402 @@
+/**
+ * @file bench_shell_latency.c
+ * @brief Keystroke-to-echo and command round-trip latency of the shell, in virtual time.
+ *
+ * Replays a terminal session against the real shell, CLI and UART driver
+ * running on the line simulator (host/Inc/uart_sim.h): the peer types each
+ * chunk of the session at its recorded time, at the simulated baud rate,
+ * and watches what comes back. Every run is deterministic.
+ *
+ *  - Echo latency: from the stop bit of a typed printable key to the stop
+ *    bit of its echo. Keys typed ahead of the prompt are not measured.
+ *  - Round trip: from the stop bit of the CR that ends a typed command to
+ *    the stop bit of the next prompt.
+ *  - Ring usage: the driver's TX/RX high-water marks and dropped bytes. TX
+ *    drops are shell output given up after SHELL_TX_TIMEOUT_MS of waiting
+ *    for ring room, e.g. long replies at a low baud rate.
+ *  - Transfers: how many transfers the driver started for the whole session
+ *    and the average bytes per transfer, with write-combining
+ *    (uart_driver_set_tx_deferred()) off and on.
+ *
+ * A session file has one chunk per line, "<delay ms> <bytes>", the delay
+ * counted from the previous chunk. The bytes may use \r, \n, \t, \e, \\ and
+ * \xHH; lines starting with '#' are comments. `uart_shell_host --record`
+ * writes one chunk per terminal read in this format. Without a file, a
+ * built-in session types a few commands and pastes a burst of them.
+ *
+ * Build: the bench_shell_latency target of the host CMake build.
+ *
+ * Usage: bench_shell_latency [session file] [ISR latency us] [main loop period us]
+ *
+ * @author Santiago Rincon
+ * @date 2026
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "main.h"
+#include "shell.h"
+#include "uart_sim.h"
+
+#define BENCH_DEFAULT_LATENCY   (2ULL)          /**< ISR latency, us */
+#define BENCH_DEFAULT_POLL      (10ULL)         /**< Main loop period, us */
+#define BENCH_MAX_CHUNK         (256U)          /**< Bytes per session line */
+#define BENCH_MAX_ECHOES        (64U)           /**< Keys waiting for their echo */
+#define BENCH_KEY_GAP_MS        (120U)          /**< Built-in session typing speed */
+#define BENCH_THINK_MS          (1000U)         /**< Built-in session pause before a command */
+#define BENCH_DRAIN_NS          (2000000000ULL) /**< Time allowed for the last reply */
+
+/**
+ * @brief One session line.
+ */
+typedef struct {
+    uint32_t delay_ms;
+    size_t length;
+    uint8_t bytes[BENCH_MAX_CHUNK];
+} bench_chunk_t;
+
+typedef struct {
+    bench_chunk_t *chunks;
+    size_t count;
+    size_t capacity;
+} bench_session_t;
+
+/**
+ * @brief Latency samples, in ns.
+ */
+typedef struct {
+    uint64_t *values;
+    size_t count;
+    size_t capacity;
+} bench_samples_t;
+
+/**
+ * @brief What the peer watches for on the line.
+ */
+typedef struct {
+    struct {
+        uint8_t byte;
+        uint64_t sent_ns;
+    } echoes[BENCH_MAX_ECHOES];
+    size_t echo_head;
+    size_t echo_count;
+    bool awaiting_prompt;   /**< Output up to the next prompt belongs to a command */
+    bool command_timed;     /**< The command being waited for is measured */
+    uint64_t command_ns;
+    size_t prompt_match;    /**< Prompt characters matched so far */
+    bench_samples_t echo;
+    bench_samples_t round_trip;
+} bench_peer_t;
+
+static UART_HandleTypeDef bench_huart = { .Instance = USART1 };
+static DMA_HandleTypeDef bench_hdma_rx;
+static DMA_HandleTypeDef bench_hdma_tx;
+static shell_t bench_shell;
+static uart_sim_t bench_sim;
+
+static const char *const bench_commands[] = {
+    "help", "version", "history", "uartstat", "help baud", "isrprof", "history", "version",
+};
+
+static void samples_add(bench_samples_t *samples, uint64_t value) {
+    if (samples->count == samples->capacity) {
+        samples->capacity = (samples->capacity == 0U) ? 64U : (2U * samples->capacity);
+        samples->values = realloc(samples->values, samples->capacity * sizeof(uint64_t));
+        if (samples->values == NULL) {
+            perror("realloc");
+            exit(EXIT_FAILURE);
+        }
+    }
+    samples->values[samples->count++] = value;
+}
+
+static int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Nearest-rank percentile of sorted samples.
+ */
+static uint64_t samples_percentile(const bench_samples_t *samples, unsigned percent) {
+    if (samples->count == 0U) {
+        return 0U;
+    }
+    size_t rank = ((samples->count * percent) + 99U) / 100U;
+    return samples->values[(rank == 0U) ? 0U : (rank - 1U)];
+}
+
+static bench_chunk_t *session_add(bench_session_t *session) {
+    if (session->count == session->capacity) {
+        session->capacity = (session->capacity == 0U) ? 64U : (2U * session->capacity);
+        session->chunks = realloc(session->chunks, session->capacity * sizeof(bench_chunk_t));
+        if (session->chunks == NULL) {
+            perror("realloc");
+            exit(EXIT_FAILURE);
+        }
+    }
+    bench_chunk_t *chunk = &session->chunks[session->count++];
+    memset(chunk, 0, sizeof(*chunk));
+    return chunk;
+}
+
+/**
+ * @brief Parses "<delay ms> <escaped bytes>".
+ */
+static bool session_parse_line(bench_session_t *session, const char *line) {
+    char *end;
+    unsigned long delay = strtoul(line, &end, 10);
+
+    if ((end == line) || (*end != ' ')) {
+        return false;
+    }
+
+    bench_chunk_t *chunk = session_add(session);
+    chunk->delay_ms = (uint32_t)delay;
+    for (const char *p = end + 1; (*p != '\0') && (*p != '\n') && (chunk->length < BENCH_MAX_CHUNK); p++) {
+        uint8_t byte = (uint8_t)*p;
+        if (*p == '\\') {
+            p++;
+            switch (*p) {
+            case 'r': byte = '\r'; break;
+            case 'n': byte = '\n'; break;
+            case 't': byte = '\t'; break;
+            case 'e': byte = 0x1BU; break;
+            case '\\': byte = '\\'; break;
+            case 'x': {
+                char hex[3] = { p[1], (p[1] != '\0') ? p[2] : '\0', '\0' };
+                byte = (uint8_t)strtoul(hex, NULL, 16);
+                p += 2;
+                break;
+            }
+            default:
+                return false;
+            }
+        }
+        chunk->bytes[chunk->length++] = byte;
+    }
+    return chunk->length > 0U;
+}
+
+static bool session_load(bench_session_t *session, const char *path) {
+    char line[(4U * BENCH_MAX_CHUNK) + 32U];
+    FILE *file = fopen(path, "r");
+    unsigned number = 0U;
+
+    if (file == NULL) {
+        perror(path);
+        return false;
+    }
+    while (fgets(line, sizeof(line), file) != NULL) {
+        number++;
+        if ((line[0] == '#') || (line[0] == '\n') || (line[0] == '\r')) {
+            continue;
+        }
+        if (!session_parse_line(session, line)) {
+            fprintf(stderr, "%s:%u: expected \"<delay ms> <bytes>\"\n", path, number);
+            fclose(file);
+            return false;
+        }
+    }
+    fclose(file);
+    return session->count > 0U;
+}
+
+/**
+ * @brief Types each command key by key, then pastes all of them at once.
+ */
+static void session_builtin(bench_session_t *session) {
+    bench_chunk_t *chunk;
+
+    for (size_t i = 0; i < (sizeof(bench_commands) / sizeof(bench_commands[0])); i++) {
+        const char *command = bench_commands[i];
+        for (size_t k = 0; command[k] != '\0'; k++) {
+            chunk = session_add(session);
+            chunk->delay_ms = (k == 0U) ? BENCH_THINK_MS : BENCH_KEY_GAP_MS;
+            chunk->bytes[chunk->length++] = (uint8_t)command[k];
+        }
+        chunk = session_add(session);
+        chunk->delay_ms = BENCH_KEY_GAP_MS;
+        chunk->bytes[chunk->length++] = '\r';
+    }
+
+    chunk = session_add(session);
+    chunk->delay_ms = BENCH_THINK_MS;
+    for (size_t i = 0; i < (sizeof(bench_commands) / sizeof(bench_commands[0])); i++) {
+        size_t length = strlen(bench_commands[i]);
+        if ((chunk->length + length + 1U) > BENCH_MAX_CHUNK) {
+            break;
+        }
+        memcpy(&chunk->bytes[chunk->length], bench_commands[i], length);
+        chunk->length += length;
+        chunk->bytes[chunk->length++] = '\r';
+    }
+}
+
+static void bench_peer_rx(void *context, uint8_t byte, uint64_t time_ns) {
+    static const char prompt[] = PROMPT_STRING;
+    bench_peer_t *peer = (bench_peer_t *)context;
+
+    if ((peer->echo_count > 0U) && (peer->echoes[peer->echo_head].byte == byte)) {
+        samples_add(&peer->echo, time_ns - peer->echoes[peer->echo_head].sent_ns);
+        peer->echo_head = (peer->echo_head + 1U) % BENCH_MAX_ECHOES;
+        peer->echo_count--;
+    }
+
+    peer->prompt_match = (byte == (uint8_t)prompt[peer->prompt_match]) ? (peer->prompt_match + 1U) :
+                         ((byte == (uint8_t)prompt[0]) ? 1U : 0U);
+    if (peer->prompt_match == (sizeof(prompt) - 1U)) {
+        peer->prompt_match = 0U;
+        if (peer->command_timed) {
+            samples_add(&peer->round_trip, time_ns - peer->command_ns);
+        }
+        peer->awaiting_prompt = false;
+        peer->command_timed = false;
+    }
+}
+
+/**
+ * @brief Sends a session chunk, noting what it should produce.
+ */
+static void bench_peer_send(bench_peer_t *peer, const bench_chunk_t *chunk) {
+    size_t sent = uart_sim_peer_send(&bench_sim, chunk->bytes, chunk->length);
+    uint64_t done_ns = uart_sim_peer_done_ns(&bench_sim);
+
+    // Only single keys typed at the prompt are timed, not pastes or type-ahead
+    if ((sent != 1U) || peer->awaiting_prompt) {
+        if (memchr(chunk->bytes, '\r', sent) != NULL) {
+            peer->awaiting_prompt = true;
+        }
+        return;
+    }
+
+    uint8_t key = chunk->bytes[0];
+    if (key == '\r') {
+        peer->awaiting_prompt = true;
+        peer->command_timed = true;
+        peer->command_ns = done_ns;
+    } else if ((key >= 0x20U) && (key < 0x7FU) && (peer->echo_count < BENCH_MAX_ECHOES)) {
+        size_t slot = (peer->echo_head + peer->echo_count) % BENCH_MAX_ECHOES;
+        peer->echoes[slot].byte = key;
+        peer->echoes[slot].sent_ns = done_ns;
+        peer->echo_count++;
+    }
+}
+
+static void bench_task(void *context) {
+    shell_task((shell_t *)context);
+}
+
+/**
+ * @brief Replays the session at one baud rate and mode, prints a result row.
+ */
+static bool run(const bench_session_t *session, uint32_t baud, bool dma, bool combine, uint64_t latency_us,
+                uint64_t poll_us) {
+    uart_sim_config_t config = UART_SIM_CONFIG_DEFAULT;
+    bench_peer_t peer = { .awaiting_prompt = true };
+    uart_driver_stats_t stats;
+
+    bench_huart.Init.BaudRate = baud;
+    bench_huart.Init.HwFlowCtl = UART_HWCONTROL_NONE;
+    bench_huart.Init.OverSampling = UART_OVERSAMPLING_16;
+    bench_huart.hdmarx = dma ? &bench_hdma_rx : NULL;
+    bench_huart.hdmatx = dma ? &bench_hdma_tx : NULL;
+    config.isr_latency_ns = latency_us * 1000U;
+    config.poll_period_ns = poll_us * 1000U;
+
+    if ((HAL_UART_Init(&bench_huart) != HAL_OK) || !uart_sim_init(&bench_sim, &bench_huart, &config)) {
+        return false;
+    }
+    uart_sim_set_peer_rx(&bench_sim, bench_peer_rx, &peer);
+
+    // Started on the simulated clock, so the banner is the first thing on the line
+    if (!shell_init(&bench_shell, &bench_huart)) {
+        uart_sim_deinit(&bench_sim);
+        return false;
+    }
+    (void) uart_driver_set_idle_hook(shell_get_driver_instance(&bench_shell), uart_sim_idle_hook, &bench_sim);
+    (void) uart_driver_set_tx_deferred(shell_get_driver_instance(&bench_shell), combine);
+    uart_sim_set_task(&bench_sim, bench_task, &bench_shell);
+
+    for (size_t i = 0; i < session->count; i++) {
+        uart_sim_run_until(&bench_sim, bench_sim.now_ns + ((uint64_t)session->chunks[i].delay_ms * 1000000ULL));
+        bench_peer_send(&peer, &session->chunks[i]);
+    }
+    uart_sim_run_until(&bench_sim, bench_sim.now_ns + BENCH_DRAIN_NS);
+    bool drained = !uart_sim_busy(&bench_sim);
+
+    (void) uart_driver_get_stats(shell_get_driver_instance(&bench_shell), &stats);
+    uart_sim_deinit(&bench_sim);
+
+    qsort(peer.echo.values, peer.echo.count, sizeof(uint64_t), compare_u64);
+    qsort(peer.round_trip.values, peer.round_trip.count, sizeof(uint64_t), compare_u64);
+
+    printf("%-6s %8u %5zu %8.1f %8.1f %8.1f %8.1f %5zu %8.2f %8.2f %8.2f %8.2f %6zu/%-4u %6zu %6zu %6lu %6.1f %s\n",
+           dma ? (combine ? "DMA+wc" : "DMA") : (combine ? "IT+wc" : "IT"), (unsigned)baud, peer.echo.count,
+           (double)samples_percentile(&peer.echo, 50U) / 1000.0,
+           (double)samples_percentile(&peer.echo, 90U) / 1000.0,
+           (double)samples_percentile(&peer.echo, 99U) / 1000.0,
+           (double)samples_percentile(&peer.echo, 100U) / 1000.0,
+           peer.round_trip.count,
+           (double)samples_percentile(&peer.round_trip, 50U) / 1e6,
+           (double)samples_percentile(&peer.round_trip, 90U) / 1e6,
+           (double)samples_percentile(&peer.round_trip, 99U) / 1e6,
+           (double)samples_percentile(&peer.round_trip, 100U) / 1e6,
+           stats.tx_high_water, (unsigned)UART_DRIVER_MAX_TX_BUFFER, stats.tx_dropped, stats.rx_dropped,
+           (unsigned long)stats.tx_transfers,
+           (stats.tx_transfers > 0U) ? ((double)stats.tx_bytes / (double)stats.tx_transfers) : 0.0,
+           drained ? "" : "(still busy)");
+
+    free(peer.echo.values);
+    free(peer.round_trip.values);
+    return drained;
+}
+
+int main(int argc, char **argv) {
+    static const uint32_t bauds[] = { 9600U, 115200U, 921600U };
+    bench_session_t session = { 0 };
+    const char *path = (argc > 1) ? argv[1] : NULL;
+    uint64_t latency_us = (argc > 2) ? strtoull(argv[2], NULL, 0) : BENCH_DEFAULT_LATENCY;
+    uint64_t poll_us = (argc > 3) ? strtoull(argv[3], NULL, 0) : BENCH_DEFAULT_POLL;
+
+    if (poll_us == 0U) {
+        fprintf(stderr, "the main loop period must be non-zero\n");
+        return EXIT_FAILURE;
+    }
+    if (path != NULL) {
+        if (!session_load(&session, path)) {
+            return EXIT_FAILURE;
+        }
+    } else {
+        session_builtin(&session);
+    }
+
+    size_t bytes = 0U;
+    for (size_t i = 0; i < session.count; i++) {
+        bytes += session.chunks[i].length;
+    }
+    printf("Session: %s, %zu chunks, %zu bytes; ISR latency %llu us, main loop every %llu us\n",
+           (path != NULL) ? path : "built-in", session.count, bytes, (unsigned long long)latency_us,
+           (unsigned long long)poll_us);
+    printf("Echo: key stop bit to echo stop bit, us. Round trip: CR stop bit to prompt stop bit, ms.\n\n");
+    printf("%-6s %8s %5s %8s %8s %8s %8s %5s %8s %8s %8s %8s %11s %6s %6s %6s %6s\n", "mode", "baud", "keys",
+           "echo p50", "p90", "p99", "max", "cmds", "rtt p50", "p90", "p99", "max", "tx ring hw", "tx drop",
+           "rx drop", "xfers", "B/xfer");
+
+    bool ok = true;
+    for (unsigned dma = 0; dma < 2U; dma++) {
+        for (unsigned combine = 0; combine < 2U; combine++) {
+            for (size_t i = 0; i < (sizeof(bauds) / sizeof(bauds[0])); i++) {
+                ok = run(&session, bauds[i], dma != 0U, combine != 0U, latency_us, poll_us) && ok;
+            }
+        }
+    }
+
+    free(session.chunks);
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
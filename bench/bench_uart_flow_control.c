@@ -0,0 +1,353 @@
+/**
+ * @file bench_uart_flow_control.c
+ * @brief RTS/CTS flow control against a simulated peer, in virtual time.
+ *
+ * Time advances one character at a time. Both directions run with and
+ * without flow control:
+ *
+ *  - RX: the peer sends a bulk transfer as long as it sees our RTS asserted,
+ *    noticing a change only after a reaction latency (USB adapters stop a
+ *    few characters late). Bytes reach a real ring_buffer_t either one per
+ *    interrupt (IT mode) or through a simulated circular DMA published at
+ *    half transfer, transfer complete and line idle (DMA mode), and RTS is
+ *    driven by flow_control_t at the watermarks, like uart_driver.c. The
+ *    main loop drains the ring at a fixed period but stalls periodically, as
+ *    during a slow command, and checks every byte against the stream.
+ *
+ *  - TX: we transmit a bulk transfer to a peer with a small receive FIFO and
+ *    a slow consumer. The peer deasserts our CTS at its own high-water mark;
+ *    with CTSE the USART finishes the frame in progress and holds the next
+ *    one, so the peer needs one character of headroom above the mark.
+ *
+ * Build:
+ *   gcc -O2 -I Core/Inc/Utilities bench/bench_uart_flow_control.c \
+ *       Core/Src/Utilities/ring_buffer.c Core/Src/Utilities/flow_control.c \
+ *       -o bench_uart_flow_control
+ *
+ * Usage: bench_uart_flow_control [bytes] [peer latency chars] [stall us]
+ *
+ * @author Santiago Rincon
+ * @date 2026
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench_common.h"
+#include "flow_control.h"
+#include "ring_buffer.h"
+
+#define BENCH_DEFAULT_BYTES     (500000ULL)     /**< Bytes sent per scenario */
+#define BENCH_DEFAULT_LATENCY   (4U)            /**< Peer reaction to RTS, characters */
+#define BENCH_DEFAULT_STALL     (20000ULL)      /**< Main loop stall, us */
+#define BENCH_STALL_PERIOD      (100000ULL)     /**< One stall every, us */
+#define BENCH_POLL_PERIOD       (100ULL)        /**< Main loop drain period, us */
+#define BENCH_IRQ_LATENCY       (20ULL)         /**< Worst-case DMA event latency, us */
+#define BENCH_CAPACITY          (256U)          /**< Same size as the UART RX ring */
+#define BENCH_DMA_GUARD         (16U)           /**< UART_DRIVER_RX_DMA_GUARD */
+#define BENCH_HIGH_WATER        ((BENCH_CAPACITY / 2U) - (BENCH_CAPACITY / 8U))
+#define BENCH_LOW_WATER         (BENCH_CAPACITY / 8U)
+#define BENCH_MAX_LATENCY       (64U)           /**< Depth of the RTS history */
+#define BENCH_MAX_EVENTS        (8U)            /**< DMA events waiting for service */
+#define BENCH_READ_CHUNK        (64U)           /**< Bytes copied per consumer read */
+
+#define BENCH_PEER_FIFO         (16U)           /**< Peer receive FIFO, TX direction */
+#define BENCH_PEER_HIGH_WATER   (BENCH_PEER_FIFO - 2U)
+#define BENCH_PEER_LOW_WATER    (BENCH_PEER_FIFO / 4U)
+#define BENCH_PEER_RATE         (3U)            /**< Peer reads one byte every N characters */
+
+typedef struct {
+    uint64_t due;               /**< Character time the event is served at */
+    size_t position;            /**< Stream position to publish up to, 0 for idle */
+    bool idle;
+} bench_event_t;
+
+typedef struct {
+    ring_buffer_t rb;
+    uint8_t storage[BENCH_CAPACITY];
+    flow_control_t fc;
+    bool flow;
+    bool dma;
+    bool rts_ready;                         /**< Our RTS output */
+    bool rts_history[BENCH_MAX_LATENCY];    /**< RTS as seen by the peer, per character */
+    size_t dma_position;
+    size_t published;
+    bench_event_t events[BENCH_MAX_EVENTS];
+    size_t event_count;
+    bench_stream_t producer;
+    bench_stream_t consumer;
+    uint64_t received;
+    uint64_t corrupt;
+    bool in_sync;
+} bench_rx_t;
+
+typedef struct {
+    uint64_t bytes;
+    uint64_t received;
+    size_t dropped;
+    uint64_t corrupt;
+    uint32_t stops;
+    size_t max_level;
+    uint64_t chars;
+} bench_stats_t;
+
+/**
+ * @brief RX interrupt side, as uart_driver_rx_throttle().
+ */
+static void rx_throttle(bench_rx_t *rx) {
+    if (rx->flow && flow_control_on_produce(&rx->fc, ring_buffer_get_count(&rx->rb))) {
+        rx->rts_ready = false;
+    }
+}
+
+/**
+ * @brief Application side, as uart_driver_rx_unthrottle().
+ */
+static void rx_unthrottle(bench_rx_t *rx) {
+    if (rx->flow && flow_control_on_consume(&rx->fc, ring_buffer_get_count(&rx->rb))) {
+        rx->rts_ready = true;
+    }
+}
+
+static void event_raise(bench_rx_t *rx, uint64_t due, size_t position, bool idle) {
+    if (rx->event_count < BENCH_MAX_EVENTS) {
+        rx->events[rx->event_count++] = (bench_event_t) { .due = due, .position = position, .idle = idle };
+    }
+}
+
+/**
+ * @brief Same arithmetic as uart_driver_rx_event_callback().
+ */
+static void event_serve(bench_rx_t *rx, size_t position) {
+    size_t last = rx->published;
+    size_t received = (position >= last) ? (position - last) : (BENCH_CAPACITY - last + position);
+
+    if (received > 0U) {
+        (void) ring_buffer_write_advance(&rx->rb, received);
+        rx->published = (position == BENCH_CAPACITY) ? 0U : position;
+        rx_throttle(rx);
+    }
+}
+
+static void events_run(bench_rx_t *rx, uint64_t now) {
+    size_t kept = 0U;
+
+    for (size_t i = 0; i < rx->event_count; i++) {
+        bench_event_t *event = &rx->events[i];
+        if (event->due > now) {
+            rx->events[kept++] = *event;
+        } else if (!event->idle) {
+            event_serve(rx, event->position);
+        } else if (rx->dma_position != 0U) {
+            event_serve(rx, rx->dma_position);
+        }
+    }
+    rx->event_count = kept;
+}
+
+/**
+ * @brief Same as uart_driver_rx_dma_sync(): drop what the stream is overwriting.
+ */
+static void consumer_sync(bench_rx_t *rx) {
+    size_t pending = (rx->dma_position - rx->published) & (BENCH_CAPACITY - 1U);
+    size_t ahead = pending + BENCH_DMA_GUARD;
+
+    (void) ring_buffer_trim(&rx->rb, (ahead < BENCH_CAPACITY) ? (BENCH_CAPACITY - ahead) : 0U);
+}
+
+static void consumer_drain(bench_rx_t *rx) {
+    uint8_t chunk[BENCH_READ_CHUNK];
+    size_t count;
+
+    if (rx->dma) {
+        consumer_sync(rx);
+    }
+    while ((count = ring_buffer_read(&rx->rb, chunk, sizeof(chunk))) > 0U) {
+        rx_unthrottle(rx);
+        rx->received += count;
+        for (size_t i = 0; rx->in_sync && (i < count); i++) {
+            if (chunk[i] != bench_stream_next(&rx->consumer)) {
+                rx->in_sync = false;
+                if (ring_buffer_get_dropped(&rx->rb) == 0U) {
+                    rx->corrupt++;
+                }
+            }
+        }
+    }
+}
+
+static bench_stats_t simulate_rx(uint32_t baud, uint64_t bytes, bool dma, bool flow, unsigned latency,
+                                 uint64_t stall_us) {
+    static bench_rx_t rx;
+    bench_stats_t stats = { .bytes = bytes };
+    uint64_t char_ns = 10000000000ULL / baud;
+    uint64_t poll_chars = (BENCH_POLL_PERIOD * 1000ULL + char_ns - 1U) / char_ns;
+    uint64_t stall_chars = (stall_us * 1000ULL) / char_ns;
+    uint64_t stall_period_chars = (BENCH_STALL_PERIOD * 1000ULL) / char_ns;
+    uint64_t irq_chars = (BENCH_IRQ_LATENCY * 1000ULL + char_ns - 1U) / char_ns;
+    uint64_t sent = 0U;
+    uint64_t now = 0U;
+
+    rx.rb = (ring_buffer_t) RING_BUFFER_INITIALIZER(rx.storage, dma ? RING_BUFFER_POLICY_OVERWRITE_OLDEST
+                                                                     : RING_BUFFER_POLICY_DROP_NEWEST);
+    (void) flow_control_init(&rx.fc, BENCH_LOW_WATER, BENCH_HIGH_WATER);
+    rx.flow = flow;
+    rx.dma = dma;
+    rx.rts_ready = true;
+    for (size_t i = 0; i < BENCH_MAX_LATENCY; i++) {
+        rx.rts_history[i] = true;
+    }
+    rx.dma_position = 0U;
+    rx.published = 0U;
+    rx.event_count = 0U;
+    rx.received = 0U;
+    rx.corrupt = 0U;
+    rx.in_sync = true;
+    bench_stream_init(&rx.producer, 0xF10C0A7EU);
+    bench_stream_init(&rx.consumer, 0xF10C0A7EU);
+
+    while ((sent < bytes) || (rx.event_count > 0U) || (rx.dma_position != rx.published) ||
+           !ring_buffer_is_empty(&rx.rb)) {
+        events_run(&rx, now);
+
+        bool stalled = (now % stall_period_chars) < stall_chars;
+        if (!stalled && ((now % poll_chars) == 0U)) {
+            consumer_drain(&rx);
+        }
+
+        // The peer acts on RTS as it was latency characters ago
+        bool peer_go = rx.rts_history[(now + BENCH_MAX_LATENCY - latency) % BENCH_MAX_LATENCY];
+        if ((sent < bytes) && peer_go) {
+            uint8_t value = bench_stream_next(&rx.producer);
+            sent++;
+            if (dma) {
+                rx.storage[rx.dma_position++] = value;
+                if (rx.dma_position == (BENCH_CAPACITY / 2U)) {
+                    event_raise(&rx, now + 1U + irq_chars, BENCH_CAPACITY / 2U, false);
+                } else if (rx.dma_position == BENCH_CAPACITY) {
+                    rx.dma_position = 0U;
+                    event_raise(&rx, now + 1U + irq_chars, BENCH_CAPACITY, false);
+                }
+            } else {
+                (void) ring_buffer_push_fast(&rx.rb, value);
+                rx_throttle(&rx);
+            }
+        } else if (dma && (rx.event_count == 0U) && (rx.dma_position != rx.published)) {
+            // Line went idle with bytes short of a half-transfer boundary
+            event_raise(&rx, now + 1U + irq_chars, 0U, true);
+        }
+
+        rx.rts_history[now % BENCH_MAX_LATENCY] = rx.rts_ready;
+        now++;
+    }
+    consumer_drain(&rx);
+
+    stats.received = rx.received;
+    stats.dropped = ring_buffer_get_dropped(&rx.rb);
+    stats.corrupt = rx.corrupt;
+    stats.stops = rx.fc.stop_count;
+    stats.max_level = ring_buffer_get_high_water(&rx.rb);
+    stats.chars = now;
+    return stats;
+}
+
+static bench_stats_t simulate_tx(uint64_t bytes, bool flow) {
+    bench_stats_t stats = { .bytes = bytes };
+    flow_control_t peer;
+    size_t level = 0U;
+    uint64_t sent = 0U;
+    uint64_t now = 0U;
+    bool cts = true;
+    bool in_flight = false;
+
+    (void) flow_control_init(&peer, BENCH_PEER_LOW_WATER, BENCH_PEER_HIGH_WATER);
+
+    while ((sent < bytes) || in_flight || (level > 0U)) {
+        // Frame completes: the byte lands in the peer FIFO
+        if (in_flight) {
+            in_flight = false;
+            if (level < BENCH_PEER_FIFO) {
+                level++;
+                stats.received++;
+            } else {
+                stats.dropped++;
+            }
+            if (flow && flow_control_on_produce(&peer, level)) {
+                cts = false;
+            }
+        }
+
+        // CTSE: the next frame starts only while CTS is asserted
+        if ((sent < bytes) && (!flow || cts)) {
+            sent++;
+            in_flight = true;
+        }
+
+        if (((now % BENCH_PEER_RATE) == 0U) && (level > 0U)) {
+            level--;
+            if (flow && flow_control_on_consume(&peer, level)) {
+                cts = true;
+            }
+        }
+
+        if (level > stats.max_level) {
+            stats.max_level = level;
+        }
+        now++;
+    }
+
+    stats.stops = peer.stop_count;
+    stats.chars = now;
+    return stats;
+}
+
+static bool report(const char *direction, const char *mode, uint32_t baud, bool flow, const bench_stats_t *stats,
+                   size_t capacity) {
+    bool ok = (stats->received == stats->bytes) && (stats->dropped == 0U) && (stats->corrupt == 0U);
+
+    printf("%-3s %-4s %8u %-4s %10llu %9zu %7llu %7u %5zu/%-4zu %10.0f %s\n", direction, mode, baud,
+           flow ? "on" : "off", (unsigned long long)stats->received, stats->dropped,
+           (unsigned long long)stats->corrupt, stats->stops, stats->max_level, capacity,
+           (double)stats->bytes * (double)baud / 10.0 / (double)stats->chars, ok ? "ok" : "LOST");
+    return ok;
+}
+
+int main(int argc, char **argv) {
+    static const uint32_t bauds[] = { 115200U, 921600U, 2000000U };
+    uint64_t bytes = (argc > 1) ? strtoull(argv[1], NULL, 0) : BENCH_DEFAULT_BYTES;
+    unsigned latency = (argc > 2) ? (unsigned)strtoul(argv[2], NULL, 0) : BENCH_DEFAULT_LATENCY;
+    uint64_t stall_us = (argc > 3) ? strtoull(argv[3], NULL, 0) : BENCH_DEFAULT_STALL;
+
+    if ((bytes == 0U) || (latency >= BENCH_MAX_LATENCY) || (stall_us >= BENCH_STALL_PERIOD)) {
+        fprintf(stderr, "bytes must be non-zero, latency below %u chars, stall below %llu us\n",
+                BENCH_MAX_LATENCY, (unsigned long long)BENCH_STALL_PERIOD);
+        return EXIT_FAILURE;
+    }
+
+    printf("RX: %u byte ring, RTS at %u/%u, peer latency %u chars, %llu us stall every %llu us\n",
+           BENCH_CAPACITY, BENCH_HIGH_WATER, BENCH_LOW_WATER, latency, (unsigned long long)stall_us,
+           (unsigned long long)BENCH_STALL_PERIOD);
+    printf("TX: %u byte peer FIFO, CTS at %u/%u, peer reads 1 byte per %u chars\n\n",
+           BENCH_PEER_FIFO, BENCH_PEER_HIGH_WATER, BENCH_PEER_LOW_WATER, BENCH_PEER_RATE);
+    printf("%-3s %-4s %8s %-4s %10s %9s %7s %7s %10s %10s %s\n", "dir", "mode", "baud", "flow", "received",
+           "dropped", "corrupt", "stops", "max fill", "bytes/s", "result");
+
+    bool ok = true;
+    for (unsigned flow = 0; flow < 2U; flow++) {
+        for (unsigned dma = 0; dma < 2U; dma++) {
+            for (size_t i = 0; i < (sizeof(bauds) / sizeof(bauds[0])); i++) {
+                bench_stats_t stats = simulate_rx(bauds[i], bytes, dma != 0U, flow != 0U, latency, stall_us);
+                bool result = report("rx", dma ? "DMA" : "IT", bauds[i], flow != 0U, &stats, BENCH_CAPACITY);
+                ok = ok && (result || (flow == 0U));
+            }
+        }
+        bench_stats_t stats = simulate_tx(bytes, flow != 0U);
+        bool result = report("tx", "-", bauds[0], flow != 0U, &stats, BENCH_PEER_FIFO);
+        ok = ok && (result || (flow == 0U));
+    }
+
+    // Only the flow-controlled runs have to be lossless
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,258 @@
+/**
+ * @file bench_uart_rx_dma.c
+ * @brief Interrupt versus circular DMA UART reception in virtual time.
+ *
+ * A simulated DMA stream writes a deterministic byte stream into the storage
+ * of a real ring_buffer_t, one byte per character time, and raises the same
+ * events HAL reports to HAL_UARTEx_RxEventCallback():
+ *  - half transfer and transfer complete, at fixed buffer positions,
+ *  - line idle, one character time after a burst ends, at the current position.
+ * Each event is served after a worst-case interrupt latency and publishes the
+ * new bytes with ring_buffer_write_advance(), like uart_driver.c. The main
+ * loop is modelled as a consumer draining the ring at a fixed period and
+ * checking every byte against the stream.
+ *
+ * IT mode takes one interrupt per byte and has to read DR before the next
+ * character is complete, so it overruns as soon as the latency exceeds one
+ * character time; that side is computed, not simulated.
+ *
+ * USART1 is clocked from APB2 (32 MHz here): fck / 16 = 2 Mbaud with 16x
+ * oversampling, fck / 8 = 4 Mbaud with OVER8.
+ *
+ * Build:
+ *   gcc -O2 -I Core/Inc/Utilities bench/bench_uart_rx_dma.c \
+ *       Core/Src/Utilities/ring_buffer.c -o bench_uart_rx_dma
+ *
+ * Usage: bench_uart_rx_dma [bytes] [latency ns] [main loop period ns]
+ *
+ * @author Santiago Rincon
+ * @date 2026
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench_common.h"
+#include "ring_buffer.h"
+
+#define BENCH_DEFAULT_BYTES     (2000000ULL)    /**< Bytes received per scenario */
+#define BENCH_DEFAULT_LATENCY   (20000ULL)      /**< Worst-case interrupt latency, ns */
+#define BENCH_DEFAULT_PERIOD    (100000ULL)     /**< Main loop drain period, ns */
+#define BENCH_CAPACITY          (256U)          /**< Same size as the UART RX ring */
+#define BENCH_DMA_GUARD         (16U)           /**< UART_DRIVER_RX_DMA_GUARD */
+#define BENCH_READ_CHUNK        (64U)           /**< Bytes copied per consumer read */
+#define BENCH_PASTE_LINE        (80U)           /**< Burst length of the paste pattern */
+#define BENCH_PASTE_GAP         (4U)            /**< Idle characters between pasted lines */
+#define BENCH_MAX_EVENTS        (8U)            /**< Events waiting for service at once */
+
+typedef enum {
+    BENCH_EVENT_HALF = 0,
+    BENCH_EVENT_FULL,
+    BENCH_EVENT_IDLE
+} bench_event_type_t;
+
+typedef struct {
+    uint64_t due_ns;
+    bench_event_type_t type;
+} bench_event_t;
+
+typedef struct {
+    ring_buffer_t rb;
+    uint8_t storage[BENCH_CAPACITY];
+    size_t dma_position;        /**< Next offset the stream writes */
+    size_t published;           /**< Offset published up to, as rx_dma_position */
+    bench_event_t events[BENCH_MAX_EVENTS];
+    size_t event_count;
+    bench_stream_t producer;
+    bench_stream_t consumer;
+    uint64_t received;
+    uint64_t interrupts;
+    uint64_t corrupt;
+    bool in_sync;
+} bench_rx_t;
+
+typedef struct {
+    uint64_t bytes;
+    uint64_t interrupts;
+    uint64_t received;
+    size_t dropped;
+    uint64_t corrupt;
+    uint64_t elapsed_ns;
+} bench_rx_stats_t;
+
+static void event_raise(bench_rx_t *rx, bench_event_type_t type, uint64_t due_ns) {
+    if (rx->event_count < BENCH_MAX_EVENTS) {
+        rx->events[rx->event_count].due_ns = due_ns;
+        rx->events[rx->event_count].type = type;
+        rx->event_count++;
+    }
+}
+
+/**
+ * @brief Same arithmetic as uart_driver_rx_event_callback().
+ */
+static void event_serve(bench_rx_t *rx, size_t position) {
+    size_t last = rx->published;
+    size_t received = (position >= last) ? (position - last) : (BENCH_CAPACITY - last + position);
+
+    rx->interrupts++;
+    if (received > 0U) {
+        (void) ring_buffer_write_advance(&rx->rb, received);
+        rx->published = (position == BENCH_CAPACITY) ? 0U : position;
+    }
+}
+
+static void events_run(bench_rx_t *rx, uint64_t now_ns) {
+    size_t kept = 0U;
+
+    for (size_t i = 0; i < rx->event_count; i++) {
+        bench_event_t *event = &rx->events[i];
+        if (event->due_ns > now_ns) {
+            rx->events[kept++] = *event;
+            continue;
+        }
+        switch (event->type) {
+            case BENCH_EVENT_HALF:
+                event_serve(rx, BENCH_CAPACITY / 2U);
+                break;
+            case BENCH_EVENT_FULL:
+                event_serve(rx, BENCH_CAPACITY);
+                break;
+            case BENCH_EVENT_IDLE:
+            default:
+                // HAL skips the callback when the stream sits exactly on a buffer boundary
+                if (rx->dma_position != 0U) {
+                    event_serve(rx, rx->dma_position);
+                }
+                break;
+        }
+    }
+    rx->event_count = kept;
+}
+
+/**
+ * @brief Same as uart_driver_rx_dma_sync(): drop what the stream is overwriting.
+ */
+static void consumer_sync(bench_rx_t *rx) {
+    size_t pending = (rx->dma_position - rx->published) & (BENCH_CAPACITY - 1U);
+    size_t ahead = pending + BENCH_DMA_GUARD;
+
+    (void) ring_buffer_trim(&rx->rb, (ahead < BENCH_CAPACITY) ? (BENCH_CAPACITY - ahead) : 0U);
+}
+
+static void consumer_drain(bench_rx_t *rx) {
+    uint8_t chunk[BENCH_READ_CHUNK];
+    size_t count;
+
+    consumer_sync(rx);
+    while ((count = ring_buffer_read(&rx->rb, chunk, sizeof(chunk))) > 0U) {
+        rx->received += count;
+        // After the first loss the stream cannot be followed any more
+        for (size_t i = 0; rx->in_sync && (i < count); i++) {
+            if (chunk[i] != bench_stream_next(&rx->consumer)) {
+                rx->in_sync = false;
+                if (ring_buffer_get_dropped(&rx->rb) == 0U) {
+                    rx->corrupt++;
+                }
+            }
+        }
+    }
+}
+
+static bench_rx_stats_t simulate(uint32_t baud, uint64_t bytes, bool paste, uint64_t latency_ns, uint64_t period_ns) {
+    static bench_rx_t rx;
+    bench_rx_stats_t stats = { .bytes = bytes };
+    uint64_t char_ns = 10000000000ULL / baud;
+    uint64_t next_poll_ns = period_ns;
+    uint64_t now_ns = 0U;
+    uint64_t sent = 0U;
+    uint32_t burst = 0U;
+
+    rx.rb = (ring_buffer_t) RING_BUFFER_INITIALIZER(rx.storage, RING_BUFFER_POLICY_OVERWRITE_OLDEST);
+    rx.dma_position = 0U;
+    rx.published = 0U;
+    rx.event_count = 0U;
+    rx.received = 0U;
+    rx.interrupts = 0U;
+    rx.corrupt = 0U;
+    rx.in_sync = true;
+    bench_stream_init(&rx.producer, 0x5EED5EEDU);
+    bench_stream_init(&rx.consumer, 0x5EED5EEDU);
+
+    while ((sent < bytes) || (rx.event_count > 0U)) {
+        events_run(&rx, now_ns);
+        if (now_ns >= next_poll_ns) {
+            consumer_drain(&rx);
+            next_poll_ns += period_ns;
+        }
+
+        bool active = (sent < bytes) && (!paste || (burst < BENCH_PASTE_LINE));
+        if (active) {
+            rx.storage[rx.dma_position++] = bench_stream_next(&rx.producer);
+            sent++;
+            burst++;
+            if (rx.dma_position == (BENCH_CAPACITY / 2U)) {
+                event_raise(&rx, BENCH_EVENT_HALF, now_ns + char_ns + latency_ns);
+            } else if (rx.dma_position == BENCH_CAPACITY) {
+                rx.dma_position = 0U;
+                event_raise(&rx, BENCH_EVENT_FULL, now_ns + char_ns + latency_ns);
+            }
+            if ((paste && (burst == BENCH_PASTE_LINE)) || (sent == bytes)) {
+                event_raise(&rx, BENCH_EVENT_IDLE, now_ns + (2U * char_ns) + latency_ns);
+            }
+        } else if (++burst >= (BENCH_PASTE_LINE + BENCH_PASTE_GAP)) {
+            burst = 0U;
+        }
+        now_ns += char_ns;
+    }
+    consumer_drain(&rx);
+
+    stats.interrupts = rx.interrupts;
+    stats.received = rx.received;
+    stats.dropped = ring_buffer_get_dropped(&rx.rb);
+    stats.corrupt = rx.corrupt;
+    stats.elapsed_ns = now_ns;
+    return stats;
+}
+
+static void report(const char *pattern, uint32_t baud, uint64_t latency_ns, const bench_rx_stats_t *stats) {
+    double seconds = (double)stats->elapsed_ns / 1e9;
+    uint64_t char_ns = 10000000000ULL / baud;
+    bool ok = (stats->received == stats->bytes) && (stats->dropped == 0U) && (stats->corrupt == 0U);
+
+    printf("%-10s %8u %12.0f %-7s %12.0f %9.1f %8zu %s\n", pattern, baud,
+           (double)stats->bytes / seconds, (latency_ns < char_ns) ? "ok" : "overrun",
+           (double)stats->interrupts / seconds, (double)stats->bytes / (double)stats->interrupts,
+           stats->dropped, ok ? "ok" : "LOST");
+}
+
+int main(int argc, char **argv) {
+    static const uint32_t bauds[] = { 115200U, 921600U, 2000000U, 4000000U };
+    uint64_t bytes = (argc > 1) ? strtoull(argv[1], NULL, 0) : BENCH_DEFAULT_BYTES;
+    uint64_t latency_ns = (argc > 2) ? strtoull(argv[2], NULL, 0) : BENCH_DEFAULT_LATENCY;
+    uint64_t period_ns = (argc > 3) ? strtoull(argv[3], NULL, 0) : BENCH_DEFAULT_PERIOD;
+
+    if ((bytes == 0U) || (period_ns == 0U)) {
+        fprintf(stderr, "bytes and period must be non-zero\n");
+        return EXIT_FAILURE;
+    }
+
+    printf("UART RX, %u byte ring, interrupt latency %llu ns, main loop period %llu ns\n",
+           BENCH_CAPACITY, (unsigned long long)latency_ns, (unsigned long long)period_ns);
+    printf("%-10s %8s %12s %-7s %12s %9s %8s %s\n", "pattern", "baud", "bytes/s", "IT",
+           "DMA irq/s", "bytes/irq", "dropped", "DMA");
+
+    bool ok = true;
+    for (unsigned pattern = 0; pattern < 2U; pattern++) {
+        bool paste = (pattern == 1U);
+        for (size_t i = 0; i < (sizeof(bauds) / sizeof(bauds[0])); i++) {
+            bench_rx_stats_t stats = simulate(bauds[i], bytes, paste, latency_ns, period_ns);
+            report(paste ? "paste" : "continuous", bauds[i], latency_ns, &stats);
+            ok = ok && (stats.received == bytes) && (stats.dropped == 0U) && (stats.corrupt == 0U);
+        }
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
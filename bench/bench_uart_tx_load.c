@@ -0,0 +1,190 @@
+/**
+ * @file bench_uart_tx_load.c
+ * @brief CPU load model of the UART TX path, interrupt versus DMA mode.
+ *
+ * Feeds shell-like output lines through a real ring_buffer_t and drains it
+ * the way uart_driver.c does in each TX mode:
+ *  - IT mode: one HAL_UART_Transmit_IT() per byte, i.e. a TXE and a TC
+ *    interrupt plus the driver callback for every character,
+ *  - DMA mode: one HAL_UART_Transmit_DMA() per contiguous readable region
+ *    (ring_buffer_read_acquire()), released on transfer complete.
+ *
+ * The number of interrupts and transfers comes from the ring itself; the
+ * cost of each one is an estimate for the STM32F429 at 64 MHz with the HAL
+ * (BENCH_CYCLES_* below). Replace them with DWT->CYCCNT measurements from
+ * the target to tighten the numbers. The link is assumed saturated, so the
+ * byte rate is baud / 10 (8N1).
+ *
+ * Two producer patterns are modelled:
+ *  - "saturated": the ring is topped up with whole lines whenever a
+ *    transfer completes, as with a busy logger,
+ *  - "line by line": each line is queued into an idle transmitter, as when
+ *    the shell answers a command.
+ *
+ * Build:
+ *   gcc -O2 -I Core/Inc/Utilities bench/bench_uart_tx_load.c \
+ *       Core/Src/Utilities/ring_buffer.c -o bench_uart_tx_load
+ *
+ * Usage: bench_uart_tx_load [bytes] [capacity]
+ *
+ * @author Santiago Rincon
+ * @date 2026
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench_common.h"
+#include "ring_buffer.h"
+
+#define BENCH_DEFAULT_BYTES     (1000000ULL)    /**< Bytes pushed through each scenario */
+#define BENCH_DEFAULT_CAPACITY  (256U)          /**< Same size as the UART TX ring */
+#define BENCH_CPU_HZ            (64000000.0)    /**< SYSCLK of this board */
+#define BENCH_LINE_MIN          (16U)           /**< Shortest generated line */
+#define BENCH_LINE_MAX          (96U)           /**< Longest generated line */
+
+#define BENCH_CYCLES_IRQ_ENTRY_EXIT     (24U)   /**< Exception entry + exit, no FPU context */
+#define BENCH_CYCLES_HAL_TXE            (60U)   /**< HAL_UART_IRQHandler, TXE path */
+#define BENCH_CYCLES_HAL_TC             (50U)   /**< HAL_UART_IRQHandler, TC path to TxCpltCallback */
+#define BENCH_CYCLES_DRIVER_IT          (25U)   /**< Callback dispatch + ring pop */
+#define BENCH_CYCLES_HAL_TRANSMIT_IT    (70U)   /**< HAL_UART_Transmit_IT() */
+#define BENCH_CYCLES_HAL_DMA_IRQ        (140U)  /**< HAL_DMA_IRQHandler + UART_DMATransmitCplt */
+#define BENCH_CYCLES_DRIVER_DMA         (60U)   /**< Callback dispatch + ring commit/acquire */
+#define BENCH_CYCLES_HAL_TRANSMIT_DMA   (250U)  /**< HAL_UART_Transmit_DMA() incl. HAL_DMA_Start_IT() */
+
+/** Cycles spent per byte in IT mode: TXE interrupt, then TC interrupt and restart */
+#define BENCH_CYCLES_PER_BYTE_IT    (BENCH_CYCLES_IRQ_ENTRY_EXIT + BENCH_CYCLES_HAL_TXE +               \
+                                     BENCH_CYCLES_IRQ_ENTRY_EXIT + BENCH_CYCLES_HAL_TC +                \
+                                     BENCH_CYCLES_DRIVER_IT + BENCH_CYCLES_HAL_TRANSMIT_IT)
+
+/** Cycles spent per transfer in DMA mode: DMA complete interrupt, then UART TC interrupt and restart */
+#define BENCH_CYCLES_PER_XFER_DMA   (BENCH_CYCLES_IRQ_ENTRY_EXIT + BENCH_CYCLES_HAL_DMA_IRQ +           \
+                                     BENCH_CYCLES_IRQ_ENTRY_EXIT + BENCH_CYCLES_HAL_TC +                \
+                                     BENCH_CYCLES_DRIVER_DMA + BENCH_CYCLES_HAL_TRANSMIT_DMA)
+
+typedef struct {
+    uint64_t bytes;         /**< Bytes transmitted */
+    uint64_t transfers;     /**< HAL transmit calls */
+    uint64_t interrupts;    /**< Interrupts taken */
+    uint64_t cycles;        /**< Estimated CPU cycles spent */
+} bench_tx_stats_t;
+
+typedef struct {
+    bench_stream_t stream;
+    size_t pending;         /**< Length of the next line, 0 if none drawn yet */
+} bench_producer_t;
+
+static size_t producer_line_length(bench_producer_t *producer) {
+    if (producer->pending == 0U) {
+        producer->pending = BENCH_LINE_MIN +
+                            (bench_stream_next(&producer->stream) % (BENCH_LINE_MAX - BENCH_LINE_MIN + 1U));
+    }
+    return producer->pending;
+}
+
+/**
+ * @brief Queues whole lines while they fit, or a single line if max_lines is 1.
+ */
+static uint64_t producer_fill(bench_producer_t *producer, ring_buffer_t *rb, uint64_t budget, unsigned max_lines) {
+    static uint8_t line[BENCH_LINE_MAX];
+    uint64_t queued = 0U;
+
+    for (unsigned lines = 0; (lines < max_lines) && (queued < budget); lines++) {
+        size_t length = producer_line_length(producer);
+        size_t free_space = ring_buffer_get_capacity(rb) - ring_buffer_get_count(rb);
+        if (length > free_space) {
+            break;
+        }
+        for (size_t i = 0; i < length; i++) {
+            line[i] = (uint8_t)(' ' + (i % 95U));
+        }
+        queued += ring_buffer_write(rb, line, length);
+        producer->pending = 0U;
+    }
+    return queued;
+}
+
+static bench_tx_stats_t simulate(size_t capacity, uint64_t bytes, bool dma, bool saturated) {
+    bench_tx_stats_t stats = { 0 };
+    bench_producer_t producer = { .pending = 0U };
+    uint8_t *storage = malloc(capacity);
+    ring_buffer_t rb;
+    uint64_t produced = 0U;
+    unsigned max_lines = saturated ? UINT32_MAX : 1U;
+
+    bench_stream_init(&producer.stream, 0xC0FFEEU);
+    ring_buffer_init_pow2(&rb, storage, capacity);
+    ring_buffer_set_policy(&rb, RING_BUFFER_POLICY_REJECT);
+
+    while (stats.bytes < bytes) {
+        if (ring_buffer_is_empty(&rb) || saturated) {
+            produced += producer_fill(&producer, &rb, bytes - produced, max_lines);
+        }
+
+        if (dma) {
+            uint8_t *region;
+            size_t length = ring_buffer_read_acquire(&rb, &region);
+            if (length == 0U) {
+                break;
+            }
+            ring_buffer_read_commit(&rb, length);
+            stats.bytes += length;
+            stats.transfers++;
+            stats.interrupts += 2U;
+            stats.cycles += BENCH_CYCLES_PER_XFER_DMA;
+        } else {
+            uint8_t value;
+            if (!ring_buffer_pop(&rb, &value)) {
+                break;
+            }
+            stats.bytes++;
+            stats.transfers++;
+            stats.interrupts += 2U;
+            stats.cycles += BENCH_CYCLES_PER_BYTE_IT;
+        }
+    }
+
+    free(storage);
+    return stats;
+}
+
+static void report(const char *pattern, uint32_t baud, const char *mode, const bench_tx_stats_t *stats) {
+    double seconds = ((double)stats->bytes * 10.0) / (double)baud;
+    double load = ((double)stats->cycles / seconds) / BENCH_CPU_HZ * 100.0;
+
+    printf("%-12s %8u %-4s %10.1f %12.0f %12.0f %8.1f%%\n", pattern, baud, mode,
+           (double)stats->bytes / (double)stats->transfers,
+           (double)stats->interrupts / seconds, (double)stats->transfers / seconds, load);
+}
+
+int main(int argc, char **argv) {
+    static const uint32_t bauds[] = { 115200U, 921600U, 2000000U };
+    uint64_t bytes = (argc > 1) ? strtoull(argv[1], NULL, 0) : BENCH_DEFAULT_BYTES;
+    size_t capacity = (argc > 2) ? (size_t)strtoul(argv[2], NULL, 0) : BENCH_DEFAULT_CAPACITY;
+
+    if (!RING_BUFFER_IS_POW2(capacity) || (capacity < BENCH_LINE_MAX)) {
+        fprintf(stderr, "capacity must be a power of two >= %u\n", BENCH_LINE_MAX);
+        return EXIT_FAILURE;
+    }
+
+    printf("UART TX CPU load model, %.0f MHz core, TX ring %zu bytes\n", BENCH_CPU_HZ / 1e6, capacity);
+    printf("estimated cycles: %u per byte (IT), %u per transfer (DMA)\n\n",
+           BENCH_CYCLES_PER_BYTE_IT, BENCH_CYCLES_PER_XFER_DMA);
+    printf("%-12s %8s %-4s %10s %12s %12s %9s\n", "pattern", "baud", "mode", "bytes/xfer", "irq/s", "xfer/s", "cpu");
+
+    for (unsigned pattern = 0; pattern < 2U; pattern++) {
+        bool saturated = (pattern == 0U);
+        const char *name = saturated ? "saturated" : "line by line";
+        bench_tx_stats_t it = simulate(capacity, bytes, false, saturated);
+        bench_tx_stats_t dma = simulate(capacity, bytes, true, saturated);
+
+        for (size_t i = 0; i < (sizeof(bauds) / sizeof(bauds[0])); i++) {
+            report(name, bauds[i], "IT", &it);
+            report(name, bauds[i], "DMA", &dma);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
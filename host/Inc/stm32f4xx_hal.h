@@ -0,0 +1,370 @@
+/**
+ * @file stm32f4xx_hal.h
+ * @brief Host stand-in for the parts of the STM32F4 HAL the shell uses.
+ *
+ * Found before the real HAL in the host build, so Core/Inc/main.h and the
+ * shell, CLI and UART driver sources compile unchanged on a workstation.
+ * The UART is modelled at the level the driver sees it: a handle with the
+ * HAL state machine, SR/DR/CR1/CR3 registers and the completion callbacks.
+ * The other end of the line is driven with the host_uart_*() functions.
+ *
+ * Interrupts cannot preempt on the host, so PRIMASK handling compiles to
+ * nothing and every "interrupt" runs from the thread calling host_uart_*().
+ *
+ * @author Santiago Rincon
+ * @date 2026
+ */
+
+#ifndef __STM32F4XX_HAL_H
+#define __STM32F4XX_HAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// --- Core ---
+
+#define SET_BIT(REG, BIT)     ((REG) |= (BIT))
+#define CLEAR_BIT(REG, BIT)   ((REG) &= ~(BIT))
+#define RESET                 0U
+
+typedef enum {
+    HAL_OK = 0x00U,
+    HAL_ERROR = 0x01U,
+    HAL_BUSY = 0x02U,
+    HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+#define HAL_MAX_DELAY 0xFFFFFFFFU
+
+static inline uint32_t __get_PRIMASK(void) {
+    return 0U;
+}
+
+static inline void __set_PRIMASK(uint32_t primask) {
+    (void) primask;
+}
+
+static inline void __disable_irq(void) {
+}
+
+/** Thread mode: the host never runs the shell from an "interrupt" that cannot wait */
+static inline uint32_t __get_IPSR(void) {
+    return 0U;
+}
+
+/** Core clock the cycle counter runs at, as configured on the target */
+extern uint32_t SystemCoreClock;
+
+typedef struct {
+    volatile uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct {
+    volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+/**
+ * @brief Cycle counter derived from the monotonic clock at SystemCoreClock.
+ * @return DWT registers with CYCCNT up to date.
+ */
+DWT_Type *host_dwt(void);
+
+extern CoreDebug_Type host_core_debug;
+
+#define DWT                         (host_dwt())
+#define CoreDebug                   (&host_core_debug)
+#define CoreDebug_DEMCR_TRCENA_Msk  (1UL << 24U)
+#define DWT_CTRL_CYCCNTENA_Msk      (1UL << 0U)
+
+/**
+ * @brief Milliseconds since the first call.
+ */
+uint32_t HAL_GetTick(void);
+
+/**
+ * @brief Time source in nanoseconds, for a simulation running in virtual time.
+ */
+typedef uint64_t (*host_clock_t)(void *context);
+
+/**
+ * @brief Drives HAL_GetTick() and the cycle counter from clock, NULL for the monotonic clock.
+ */
+void host_set_clock(host_clock_t clock, void *context);
+
+uint32_t HAL_RCC_GetPCLK1Freq(void);
+uint32_t HAL_RCC_GetPCLK2Freq(void);
+
+// --- GPIO ---
+
+typedef struct {
+    volatile uint32_t ODR;
+} GPIO_TypeDef;
+
+typedef enum {
+    GPIO_PIN_RESET = 0,
+    GPIO_PIN_SET
+} GPIO_PinState;
+
+#define GPIO_PIN_9      ((uint16_t)0x0200)
+#define GPIO_PIN_10     ((uint16_t)0x0400)
+#define GPIO_PIN_11     ((uint16_t)0x0800)
+#define GPIO_PIN_12     ((uint16_t)0x1000)
+#define GPIO_PIN_13     ((uint16_t)0x2000)
+#define GPIO_PIN_14     ((uint16_t)0x4000)
+
+extern GPIO_TypeDef host_gpio[7];
+
+#define GPIOA   (&host_gpio[0])
+#define GPIOG   (&host_gpio[6])
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+
+// --- USART registers ---
+
+typedef struct {
+    volatile uint32_t SR;
+    volatile uint32_t DR;
+    volatile uint32_t BRR;
+    volatile uint32_t CR1;
+    volatile uint32_t CR2;
+    volatile uint32_t CR3;
+    volatile uint32_t GTPR;
+} USART_TypeDef;
+
+/** One register block per 1 KB, like the peripheral map, so driver registry slots stay distinct */
+typedef union {
+    USART_TypeDef regs;
+    uint8_t window[1024];
+} host_usart_window_t;
+
+extern host_usart_window_t host_usart[8];
+
+#define USART1  (&host_usart[0].regs)
+#define USART6  (&host_usart[1].regs)
+#define USART2  (&host_usart[2].regs)
+#define USART3  (&host_usart[3].regs)
+#define UART4   (&host_usart[4].regs)
+#define UART5   (&host_usart[5].regs)
+#define UART7   (&host_usart[6].regs)
+#define UART8   (&host_usart[7].regs)
+
+#define USART_SR_PE         0x0001U
+#define USART_SR_FE         0x0002U
+#define USART_SR_NE         0x0004U
+#define USART_SR_ORE        0x0008U
+#define USART_SR_IDLE       0x0010U
+#define USART_SR_RXNE       0x0020U
+#define USART_SR_TC         0x0040U
+#define USART_SR_TXE        0x0080U
+
+#define USART_CR1_RXNEIE    0x0020U
+#define USART_CR1_TCIE      0x0040U
+#define USART_CR1_TXEIE     0x0080U
+
+#define USART_CR3_CTSE      0x0200U
+
+// --- UART HAL ---
+
+#define UART_WORDLENGTH_8B      0x00000000U
+#define UART_STOPBITS_1         0x00000000U
+#define UART_PARITY_NONE        0x00000000U
+#define UART_MODE_TX_RX         0x0000000CU
+
+#define UART_HWCONTROL_NONE     0x00000000U
+#define UART_HWCONTROL_CTS      USART_CR3_CTSE
+
+#define UART_OVERSAMPLING_16    0x00000000U
+#define UART_OVERSAMPLING_8     0x00008000U
+
+#define UART_FLAG_TC            USART_SR_TC
+#define UART_IT_RXNE            USART_CR1_RXNEIE
+#define UART_IT_TXE             USART_CR1_TXEIE
+
+#define HAL_UART_ERROR_NONE     0x00000000U
+#define HAL_UART_ERROR_PE       0x00000001U
+#define HAL_UART_ERROR_NE       0x00000002U
+#define HAL_UART_ERROR_FE       0x00000004U
+#define HAL_UART_ERROR_ORE      0x00000008U
+#define HAL_UART_ERROR_DMA      0x00000010U
+
+/* BRR computation, as in stm32f4xx_hal_uart.h */
+#define UART_DIV_SAMPLING16(_PCLK_, _BAUD_)         ((uint32_t)((((uint64_t)(_PCLK_))*25U)/(4U*((uint64_t)(_BAUD_)))))
+#define UART_DIVMANT_SAMPLING16(_PCLK_, _BAUD_)     (UART_DIV_SAMPLING16((_PCLK_), (_BAUD_))/100U)
+#define UART_DIVFRAQ_SAMPLING16(_PCLK_, _BAUD_)     ((((UART_DIV_SAMPLING16((_PCLK_), (_BAUD_)) - (UART_DIVMANT_SAMPLING16((_PCLK_), (_BAUD_)) * 100U)) * 16U)\
+                                                      + 50U) / 100U)
+#define UART_BRR_SAMPLING16(_PCLK_, _BAUD_)         ((UART_DIVMANT_SAMPLING16((_PCLK_), (_BAUD_)) << 4U) + \
+                                                     (UART_DIVFRAQ_SAMPLING16((_PCLK_), (_BAUD_)) & 0xF0U) + \
+                                                     (UART_DIVFRAQ_SAMPLING16((_PCLK_), (_BAUD_)) & 0x0FU))
+
+#define UART_DIV_SAMPLING8(_PCLK_, _BAUD_)          ((uint32_t)((((uint64_t)(_PCLK_))*25U)/(2U*((uint64_t)(_BAUD_)))))
+#define UART_DIVMANT_SAMPLING8(_PCLK_, _BAUD_)      (UART_DIV_SAMPLING8((_PCLK_), (_BAUD_))/100U)
+#define UART_DIVFRAQ_SAMPLING8(_PCLK_, _BAUD_)      ((((UART_DIV_SAMPLING8((_PCLK_), (_BAUD_)) - (UART_DIVMANT_SAMPLING8((_PCLK_), (_BAUD_)) * 100U)) * 8U)\
+                                                      + 50U) / 100U)
+#define UART_BRR_SAMPLING8(_PCLK_, _BAUD_)          ((UART_DIVMANT_SAMPLING8((_PCLK_), (_BAUD_)) << 4U) + \
+                                                     ((UART_DIVFRAQ_SAMPLING8((_PCLK_), (_BAUD_)) & 0xF8U) << 1U) + \
+                                                     (UART_DIVFRAQ_SAMPLING8((_PCLK_), (_BAUD_)) & 0x07U))
+
+typedef enum {
+    HAL_UART_STATE_RESET = 0x00U,
+    HAL_UART_STATE_READY = 0x20U,
+    HAL_UART_STATE_BUSY_TX = 0x21U,
+    HAL_UART_STATE_BUSY_RX = 0x22U
+} HAL_UART_StateTypeDef;
+
+typedef enum {
+    HAL_UART_RECEPTION_STANDARD = 0x00U,
+    HAL_UART_RECEPTION_TOIDLE = 0x01U
+} HAL_UART_RxTypeTypeDef;
+
+typedef struct {
+    uint32_t BaudRate;
+    uint32_t WordLength;
+    uint32_t StopBits;
+    uint32_t Parity;
+    uint32_t Mode;
+    uint32_t HwFlowCtl;
+    uint32_t OverSampling;
+} UART_InitTypeDef;
+
+/** Presence of a handle selects DMA mode in the driver; the stand-in moves the data itself */
+typedef struct {
+    uint32_t Channel;
+    volatile uint32_t Counter;              /**< Stand-in for NDTR: transfers left before the stream wraps */
+} DMA_HandleTypeDef;
+
+#define __HAL_DMA_GET_COUNTER(__HANDLE__) ((__HANDLE__)->Counter)
+
+typedef struct __UART_HandleTypeDef {
+    USART_TypeDef *Instance;
+    UART_InitTypeDef Init;
+    const uint8_t *pTxBuffPtr;
+    uint16_t TxXferSize;
+    uint16_t TxXferCount;                   /**< Bytes of the transfer not yet on the line */
+    uint8_t *pRxBuffPtr;
+    uint16_t RxXferSize;
+    uint16_t RxXferCount;                   /**< Stand-in: DMA write offset in circular reception */
+    volatile HAL_UART_RxTypeTypeDef ReceptionType;
+    DMA_HandleTypeDef *hdmatx;
+    DMA_HandleTypeDef *hdmarx;
+    volatile HAL_UART_StateTypeDef gState;
+    volatile HAL_UART_StateTypeDef RxState;
+    volatile uint32_t ErrorCode;
+} UART_HandleTypeDef;
+
+#define __HAL_UART_ENABLE_IT(__HANDLE__, __INTERRUPT__)   ((__HANDLE__)->Instance->CR1 |= (__INTERRUPT__))
+#define __HAL_UART_DISABLE_IT(__HANDLE__, __INTERRUPT__)  ((__HANDLE__)->Instance->CR1 &= ~(__INTERRUPT__))
+#define __HAL_UART_GET_FLAG(__HANDLE__, __FLAG__)         (((__HANDLE__)->Instance->SR & (__FLAG__)) == (__FLAG__))
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef *huart);
+HAL_StatusTypeDef HAL_UART_DeInit(UART_HandleTypeDef *huart);
+HAL_StatusTypeDef HAL_UART_Transmit_IT(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_AbortTransmit(UART_HandleTypeDef *huart);
+HAL_StatusTypeDef HAL_UART_AbortReceive(UART_HandleTypeDef *huart);
+void HAL_UART_IRQHandler(UART_HandleTypeDef *huart);
+
+/* Defined by the application, as stm32f4xx_it.c does on the target */
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart);
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart);
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size);
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart);
+
+// --- Host side of the line ---
+
+/**
+ * @brief Receives what the transmitter puts on the line.
+ */
+typedef void (*host_uart_sink_t)(UART_HandleTypeDef *huart, const uint8_t *data, size_t length);
+
+/**
+ * @brief Sets where transmitted bytes go, NULL to discard them.
+ */
+void host_uart_set_sink(host_uart_sink_t sink);
+
+/**
+ * @brief Bytes arriving from the peer, followed by an idle line.
+ *
+ * In interrupt reception each byte raises the UART interrupt; a byte that
+ * arrives before the previous one was read is lost as an overrun, as on the
+ * target. In circular DMA reception the bytes are written to the buffer,
+ * with the half, full and idle events.
+ *
+ * @param huart UART handle.
+ * @param data Received bytes.
+ * @param length Number of bytes.
+ */
+void host_uart_rx(UART_HandleTypeDef *huart, const uint8_t *data, size_t length);
+
+/**
+ * @brief One byte arriving from the peer.
+ *
+ * Raises the USART interrupt in interrupt reception; in circular DMA
+ * reception stores the byte and raises the half and full transfer events.
+ *
+ * @param huart UART handle.
+ * @param byte Received byte.
+ */
+void host_uart_rx_byte(UART_HandleTypeDef *huart, uint8_t byte);
+
+/**
+ * @brief The line went idle: the idle event of circular DMA reception.
+ *
+ * @param huart UART handle.
+ */
+void host_uart_rx_idle(UART_HandleTypeDef *huart);
+
+/**
+ * @brief Next byte of the HAL transfer in progress, fed without an interrupt as by the DMA stream.
+ *
+ * @param huart UART handle.
+ * @param byte Set to the byte.
+ * @return true if there was one.
+ */
+bool host_uart_tx_fetch(UART_HandleTypeDef *huart, uint8_t *byte);
+
+/**
+ * @brief Whether the transmitter waits for an interrupt: a HAL transfer
+ * whose bytes have all been fetched, or TXE enabled by the register handler.
+ *
+ * @param huart UART handle.
+ * @return true if host_uart_tx_irq() has something to do.
+ */
+bool host_uart_tx_irq_pending(UART_HandleTypeDef *huart);
+
+/**
+ * @brief Serves the transmitter interrupt.
+ *
+ * Ends a HAL transfer with the TX complete callback, or raises TXE for the
+ * register handler, which may write the next byte to DR.
+ *
+ * @param huart UART handle.
+ * @param byte Set to the byte the handler wrote.
+ * @return true if the handler wrote a byte.
+ */
+bool host_uart_tx_irq(UART_HandleTypeDef *huart, uint8_t *byte);
+
+/**
+ * @brief Completes every transfer the transmitter has been given.
+ *
+ * Chained transfers started from the TX complete callback are completed
+ * too, until the transmitter is idle.
+ *
+ * @param huart UART handle.
+ */
+void host_uart_tx_poll(UART_HandleTypeDef *huart);
+
+/**
+ * @brief The USART interrupt: the application's USARTx_IRQHandler.
+ *
+ * Defined by the application; it decides between the register-level
+ * handler and HAL_UART_IRQHandler(), as on the target.
+ *
+ * @param huart UART handle.
+ */
+void host_uart_irq(UART_HandleTypeDef *huart);
+
+#endif /* __STM32F4XX_HAL_H */
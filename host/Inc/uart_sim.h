@@ -0,0 +1,206 @@
+/**
+ * @file uart_sim.h
+ * @brief Virtual-time simulation of a UART line under the HAL stand-in.
+ *
+ * Runs the real UART driver and whatever sits on it (normally the shell)
+ * against a peer on the other end of the line, with time advancing only
+ * through simulated events. The model:
+ *
+ *  - Each character occupies the line for frame_bits bit times at the baud
+ *    rate, in both directions; the peer sends back to back.
+ *  - Every interrupt or HAL callback runs isr_latency_ns after the hardware
+ *    event that raised it. A received byte is handed to the driver that long
+ *    after its stop bit, the DMA idle event that long after one idle frame.
+ *  - HAL transfers (DMA or interrupt) stream their bytes without gaps and end
+ *    with the TX complete callback once the last byte has left the line. The
+ *    register handler reloads DR from the TXE interrupt while the previous
+ *    byte shifts out, so it only leaves gaps when the latency exceeds a frame.
+ *  - The main loop task runs every poll_period_ns; handler and task code
+ *    take no time. A blocking call waiting inside the task advances time
+ *    through uart_sim_idle_hook().
+ *
+ * With HAL_GetTick() and the cycle counter following the simulated clock,
+ * timeouts and the driver's statistics are in virtual time as well, so every
+ * run is deterministic and independent of the host's speed.
+ *
+ * @author Santiago Rincon
+ * @date 2026
+ */
+
+#ifndef __UART_SIM_H__
+#define __UART_SIM_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "main.h"
+#include "element_ring.h"
+
+/**
+ * @def UART_SIM_PEER_QUEUE
+ * @brief Bytes the peer can have queued for sending.
+ */
+#ifndef UART_SIM_PEER_QUEUE
+#define UART_SIM_PEER_QUEUE 4096U
+#endif
+
+/**
+ * @brief Simulation parameters.
+ */
+typedef struct uart_sim_config_ {
+    uint32_t baud_rate;         /**< Line rate, 0 to take it from the UART handle */
+    uint32_t frame_bits;        /**< Bits per character on the line, 10 for 8N1 */
+    uint64_t isr_latency_ns;    /**< From a hardware event to its interrupt or callback */
+    uint64_t poll_period_ns;    /**< Period of the main loop task */
+
+} uart_sim_config_t;
+
+/**
+ * @def UART_SIM_CONFIG_DEFAULT
+ * @brief 8N1 at the handle's baud rate, 2 us interrupt latency, 10 us main loop.
+ */
+#define UART_SIM_CONFIG_DEFAULT { .baud_rate = 0U, .frame_bits = 10U, .isr_latency_ns = 2000U, \
+                                  .poll_period_ns = 10000U }
+
+/**
+ * @brief Called for each byte the peer receives, at the end of its stop bit.
+ */
+typedef void (*uart_sim_peer_rx_t)(void *context, uint8_t byte, uint64_t time_ns);
+
+/**
+ * @brief The main loop body, e.g. a wrapper around shell_task().
+ */
+typedef void (*uart_sim_task_t)(void *context);
+
+/**
+ * @brief A byte on its way from the peer.
+ */
+typedef struct uart_sim_rx_ {
+    uint64_t end_ns;    /**< End of its stop bit */
+    uint8_t byte;
+
+} uart_sim_rx_t;
+
+/**
+ * @brief Simulation state.
+ */
+typedef struct uart_sim_ {
+    UART_HandleTypeDef *huart;
+    uart_sim_config_t config;
+    uint64_t now_ns;                /**< Simulated time */
+
+    uart_sim_task_t task;
+    void *task_context;
+    uint64_t task_ns;               /**< Next run of the task */
+    bool in_task;                   /**< Task running: only line events can advance time */
+
+    uart_sim_peer_rx_t peer_rx;
+    void *peer_context;
+
+    // Transmitter: shift register, DR loaded by the register handler, pending interrupt
+    bool tx_shifting;
+    uint8_t tx_shift;
+    uint64_t tx_shift_end_ns;
+    bool tx_holding;
+    uint8_t tx_hold;
+    bool tx_irq_scheduled;
+    uint64_t tx_irq_ns;
+    bool tx_stalled;                /**< TXE served without a byte; retried after the next task */
+
+    // Receiver: bytes from the peer in line order, the first one taken out to see its time
+    element_ring_t rx_queue;
+    uart_sim_rx_t rx_storage[UART_SIM_PEER_QUEUE];
+    uart_sim_rx_t rx_next;
+    bool rx_next_valid;
+    uint64_t rx_line_free_ns;       /**< When the peer can start its next byte */
+    uint64_t rx_idle_ns;            /**< Idle event due, valid if rx_idle_scheduled */
+    bool rx_idle_scheduled;
+
+    uint64_t tx_bytes;              /**< Bytes that left the line towards the peer */
+    uint64_t rx_bytes;              /**< Bytes handed to the driver */
+
+} uart_sim_t;
+
+/**
+ * @brief Starts a simulation at time 0 and makes it the HAL time source.
+ *
+ * Call before the driver is started, so everything it does happens in
+ * simulated time. The UART handle must have been initialized.
+ *
+ * @param sim Pointer to simulation state.
+ * @param huart UART handle the driver runs on.
+ * @param config Parameters, NULL for UART_SIM_CONFIG_DEFAULT.
+ * @return true if started, false if arguments are invalid.
+ */
+bool uart_sim_init(uart_sim_t *sim, UART_HandleTypeDef *huart, const uart_sim_config_t *config);
+
+/**
+ * @brief Hands the HAL time source back to the host clock.
+ *
+ * @param sim Pointer to simulation state.
+ */
+void uart_sim_deinit(uart_sim_t *sim);
+
+/**
+ * @brief Sets the main loop task.
+ *
+ * @param sim Pointer to simulation state.
+ * @param task Task, NULL for none.
+ * @param context Passed to task.
+ */
+void uart_sim_set_task(uart_sim_t *sim, uart_sim_task_t task, void *context);
+
+/**
+ * @brief Sets the receiver of what the driver transmits.
+ *
+ * @param sim Pointer to simulation state.
+ * @param peer_rx Called per byte, NULL to discard.
+ * @param context Passed to peer_rx.
+ */
+void uart_sim_set_peer_rx(uart_sim_t *sim, uart_sim_peer_rx_t peer_rx, void *context);
+
+/**
+ * @brief The peer sends bytes, starting now or when its previous bytes are out.
+ *
+ * @param sim Pointer to simulation state.
+ * @param data Bytes to send.
+ * @param length Number of bytes.
+ * @return Number of bytes queued, fewer if the peer queue is full.
+ */
+size_t uart_sim_peer_send(uart_sim_t *sim, const uint8_t *data, size_t length);
+
+/**
+ * @brief When the last byte the peer has queued will have arrived.
+ *
+ * @param sim Pointer to simulation state.
+ * @return End of its stop bit, or the current time if the line is idle.
+ */
+uint64_t uart_sim_peer_done_ns(const uart_sim_t *sim);
+
+/**
+ * @brief Runs the simulation up to a point in time.
+ *
+ * @param sim Pointer to simulation state.
+ * @param until_ns Time to stop at.
+ */
+void uart_sim_run_until(uart_sim_t *sim, uint64_t until_ns);
+
+/**
+ * @brief Whether any line activity is still pending in either direction.
+ *
+ * @param sim Pointer to simulation state.
+ * @return true while bytes are on the line, queued or waiting for an interrupt.
+ */
+bool uart_sim_busy(uart_sim_t *sim);
+
+/**
+ * @brief uart_driver_idle_hook_t for the driver under simulation.
+ *
+ * Lets a blocking send or flush wait in simulated time: each call runs the
+ * next line event, or lets one poll period pass if there is none.
+ *
+ * @param context The uart_sim_t.
+ */
+void uart_sim_idle_hook(void *context);
+
+#endif /* __UART_SIM_H__ */
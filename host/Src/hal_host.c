@@ -0,0 +1,366 @@
+/**
+ * @file hal_host.c
+ * @brief Host stand-in for the STM32F4 HAL UART, GPIO, RCC and tick.
+ *
+ * Transfers started through the HAL are held until host_uart_tx_poll(),
+ * which hands them to the sink and runs the completion callback, as the
+ * TX complete interrupt would. Received bytes are delivered by
+ * host_uart_rx() through the application's USART interrupt or the RX event
+ * callback, the same paths the firmware takes.
+ *
+ * @author Santiago Rincon
+ * @date 2026
+ */
+
+#include <time.h>
+#include "stm32f4xx_hal.h"
+
+/** DR value no byte can have, to see whether the register handler wrote one */
+#define HOST_DR_EMPTY 0xFFFFFFFFU
+
+/** Status register of an idle USART */
+#define HOST_SR_IDLE (USART_SR_TXE | USART_SR_TC)
+
+uint32_t SystemCoreClock = 64000000U;
+CoreDebug_Type host_core_debug;
+GPIO_TypeDef host_gpio[7];
+host_usart_window_t host_usart[8];
+
+static DWT_Type host_dwt_regs;
+static host_uart_sink_t host_sink;
+static host_clock_t host_clock;
+static void *host_clock_context;
+
+void host_set_clock(host_clock_t clock, void *context) {
+    host_clock_context = context;
+    host_clock = clock;
+}
+
+/**
+ * @brief Nanoseconds since the first call, or the time of the clock set with host_set_clock().
+ */
+static uint64_t host_elapsed_ns(void) {
+    static uint64_t origin;
+    struct timespec now;
+
+    if (host_clock != NULL) {
+        return host_clock(host_clock_context);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    uint64_t ns = ((uint64_t) now.tv_sec * 1000000000ULL) + (uint64_t) now.tv_nsec;
+    if (origin == 0U) {
+        origin = ns;
+    }
+    return ns - origin;
+}
+
+DWT_Type *host_dwt(void) {
+    if ((host_dwt_regs.CTRL & DWT_CTRL_CYCCNTENA_Msk) != 0U) {
+        host_dwt_regs.CYCCNT = (uint32_t)((host_elapsed_ns() * (SystemCoreClock / 1000000U)) / 1000U);
+    }
+    return &host_dwt_regs;
+}
+
+uint32_t HAL_GetTick(void) {
+    return (uint32_t)(host_elapsed_ns() / 1000000U);
+}
+
+uint32_t HAL_RCC_GetPCLK1Freq(void) {
+    return SystemCoreClock / 2U;
+}
+
+uint32_t HAL_RCC_GetPCLK2Freq(void) {
+    return SystemCoreClock / 2U;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState) {
+    if (PinState != GPIO_PIN_RESET) {
+        GPIOx->ODR |= GPIO_Pin;
+    } else {
+        GPIOx->ODR &= ~(uint32_t) GPIO_Pin;
+    }
+}
+
+// --- UART ---
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef *huart) {
+    if ((huart == NULL) || (huart->Instance == NULL) || (huart->Init.BaudRate == 0U)) {
+        return HAL_ERROR;
+    }
+
+    USART_TypeDef *usart = huart->Instance;
+    uint32_t pclk = ((usart == USART1) || (usart == USART6)) ? HAL_RCC_GetPCLK2Freq() : HAL_RCC_GetPCLK1Freq();
+
+    usart->SR = HOST_SR_IDLE;
+    usart->CR1 = 0U;
+    usart->CR3 = huart->Init.HwFlowCtl;
+    usart->BRR = (huart->Init.OverSampling == UART_OVERSAMPLING_8) ?
+                 UART_BRR_SAMPLING8(pclk, huart->Init.BaudRate) : UART_BRR_SAMPLING16(pclk, huart->Init.BaudRate);
+
+    huart->TxXferSize = 0U;
+    huart->TxXferCount = 0U;
+    huart->RxXferSize = 0U;
+    huart->ErrorCode = HAL_UART_ERROR_NONE;
+    huart->gState = HAL_UART_STATE_READY;
+    huart->RxState = HAL_UART_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_DeInit(UART_HandleTypeDef *huart) {
+    if (huart == NULL) {
+        return HAL_ERROR;
+    }
+
+    huart->Instance->CR1 = 0U;
+    huart->gState = HAL_UART_STATE_RESET;
+    huart->RxState = HAL_UART_STATE_RESET;
+    return HAL_OK;
+}
+
+/**
+ * @brief Holds a transfer until host_uart_tx_poll() puts it on the line.
+ */
+static HAL_StatusTypeDef host_uart_start_tx(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size) {
+    if (huart->gState != HAL_UART_STATE_READY) {
+        return HAL_BUSY;
+    }
+    if ((pData == NULL) || (Size == 0U)) {
+        return HAL_ERROR;
+    }
+
+    huart->pTxBuffPtr = pData;
+    huart->TxXferSize = Size;
+    huart->TxXferCount = Size;
+    huart->ErrorCode = HAL_UART_ERROR_NONE;
+    huart->gState = HAL_UART_STATE_BUSY_TX;
+    huart->Instance->SR &= ~USART_SR_TC;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_IT(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size) {
+    return host_uart_start_tx(huart, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size) {
+    return host_uart_start_tx(huart, pData, Size);
+}
+
+/**
+ * @brief Arms reception into pData.
+ */
+static HAL_StatusTypeDef host_uart_start_rx(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size,
+                                            HAL_UART_RxTypeTypeDef type) {
+    if (huart->RxState != HAL_UART_STATE_READY) {
+        return HAL_BUSY;
+    }
+    if ((pData == NULL) || (Size == 0U)) {
+        return HAL_ERROR;
+    }
+
+    huart->pRxBuffPtr = pData;
+    huart->RxXferSize = Size;
+    huart->RxXferCount = 0U;
+    if ((type == HAL_UART_RECEPTION_TOIDLE) && (huart->hdmarx != NULL)) {
+        huart->hdmarx->Counter = Size;
+    }
+    huart->ReceptionType = type;
+    huart->ErrorCode = HAL_UART_ERROR_NONE;
+    huart->RxState = HAL_UART_STATE_BUSY_RX;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size) {
+    return host_uart_start_rx(huart, pData, Size, HAL_UART_RECEPTION_STANDARD);
+}
+
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size) {
+    return host_uart_start_rx(huart, pData, Size, HAL_UART_RECEPTION_TOIDLE);
+}
+
+HAL_StatusTypeDef HAL_UART_AbortTransmit(UART_HandleTypeDef *huart) {
+    huart->Instance->CR1 &= ~(USART_CR1_TXEIE | USART_CR1_TCIE);
+    huart->Instance->SR |= HOST_SR_IDLE;
+    huart->TxXferSize = 0U;
+    huart->TxXferCount = 0U;
+    huart->gState = HAL_UART_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_AbortReceive(UART_HandleTypeDef *huart) {
+    huart->RxXferSize = 0U;
+    huart->ReceptionType = HAL_UART_RECEPTION_STANDARD;
+    huart->RxState = HAL_UART_STATE_READY;
+    return HAL_OK;
+}
+
+/**
+ * @brief Interrupt reception of the HAL: store the byte, then report errors.
+ *
+ * As in the real handler, an overrun stops reception before the error
+ * callback; framing, noise and parity errors are reported with reception
+ * left running. A byte arriving while reception is not armed is dropped.
+ */
+void HAL_UART_IRQHandler(UART_HandleTypeDef *huart) {
+    USART_TypeDef *usart = huart->Instance;
+    uint32_t status = usart->SR;
+    uint32_t error = (((status & USART_SR_PE) != 0U) ? HAL_UART_ERROR_PE : 0U) |
+                     (((status & USART_SR_FE) != 0U) ? HAL_UART_ERROR_FE : 0U) |
+                     (((status & USART_SR_NE) != 0U) ? HAL_UART_ERROR_NE : 0U) |
+                     (((status & USART_SR_ORE) != 0U) ? HAL_UART_ERROR_ORE : 0U);
+
+    if ((status & (USART_SR_RXNE | USART_SR_ORE)) == 0U) {
+        return;
+    }
+
+    uint8_t byte = (uint8_t) usart->DR;
+    usart->SR &= ~(USART_SR_RXNE | USART_SR_ORE | USART_SR_FE | USART_SR_NE | USART_SR_PE);
+    huart->ErrorCode |= error;
+
+    if ((huart->RxState == HAL_UART_STATE_BUSY_RX) && (huart->ReceptionType == HAL_UART_RECEPTION_STANDARD)) {
+        huart->pRxBuffPtr[huart->RxXferCount++] = byte;
+        if (huart->RxXferCount == huart->RxXferSize) {
+            huart->RxState = HAL_UART_STATE_READY;
+            HAL_UART_RxCpltCallback(huart);
+        }
+    }
+
+    if (error == 0U) {
+        return;
+    }
+    if ((error & HAL_UART_ERROR_ORE) != 0U) {
+        (void) HAL_UART_AbortReceive(huart);
+        HAL_UART_ErrorCallback(huart);
+    } else {
+        HAL_UART_ErrorCallback(huart);
+        huart->ErrorCode = HAL_UART_ERROR_NONE;
+    }
+}
+
+// --- Host side of the line ---
+
+void host_uart_set_sink(host_uart_sink_t sink) {
+    host_sink = sink;
+}
+
+void host_uart_rx_byte(UART_HandleTypeDef *huart, uint8_t byte) {
+    if (huart == NULL) {
+        return;
+    }
+
+    if ((huart->RxState == HAL_UART_STATE_BUSY_RX) && (huart->ReceptionType == HAL_UART_RECEPTION_TOIDLE)) {
+        // Circular DMA: half and full transfer events as the HAL raises them
+        huart->pRxBuffPtr[huart->RxXferCount++] = byte;
+        if (huart->hdmarx != NULL) {
+            // NDTR reloads to the full size when the stream wraps
+            huart->hdmarx->Counter = (huart->RxXferCount == huart->RxXferSize) ? huart->RxXferSize
+                                                                               : (huart->RxXferSize - huart->RxXferCount);
+        }
+        if (huart->RxXferCount == (huart->RxXferSize / 2U)) {
+            HAL_UARTEx_RxEventCallback(huart, huart->RxXferCount);
+        } else if (huart->RxXferCount == huart->RxXferSize) {
+            huart->RxXferCount = 0U;
+            HAL_UARTEx_RxEventCallback(huart, huart->RxXferSize);
+        }
+        return;
+    }
+
+    // TXE is held off so a pending register transmission is not served from the RX interrupt
+    USART_TypeDef *usart = huart->Instance;
+    uint32_t txe = usart->SR & USART_SR_TXE;
+    usart->DR = byte;
+    usart->SR = (usart->SR & ~USART_SR_TXE) | USART_SR_RXNE;
+    host_uart_irq(huart);
+    // Reading DR in the handler clears RXNE and the error flags
+    usart->SR = (usart->SR & ~(USART_SR_RXNE | USART_SR_ORE | USART_SR_FE | USART_SR_NE | USART_SR_PE)) | txe;
+}
+
+void host_uart_rx_idle(UART_HandleTypeDef *huart) {
+    // Like the HAL, no event when the stream stopped exactly on the end of the buffer
+    if ((huart != NULL) && (huart->RxState == HAL_UART_STATE_BUSY_RX) &&
+        (huart->ReceptionType == HAL_UART_RECEPTION_TOIDLE) && (huart->RxXferCount != 0U)) {
+        HAL_UARTEx_RxEventCallback(huart, huart->RxXferCount);
+    }
+}
+
+void host_uart_rx(UART_HandleTypeDef *huart, const uint8_t *data, size_t length) {
+    if ((huart == NULL) || (data == NULL)) {
+        return;
+    }
+
+    for (size_t i = 0U; i < length; i++) {
+        host_uart_rx_byte(huart, data[i]);
+    }
+    host_uart_rx_idle(huart);
+}
+
+bool host_uart_tx_fetch(UART_HandleTypeDef *huart, uint8_t *byte) {
+    if ((huart == NULL) || (huart->gState != HAL_UART_STATE_BUSY_TX) || (huart->TxXferCount == 0U)) {
+        return false;
+    }
+
+    *byte = huart->pTxBuffPtr[huart->TxXferSize - huart->TxXferCount];
+    huart->TxXferCount--;
+    return true;
+}
+
+bool host_uart_tx_irq_pending(UART_HandleTypeDef *huart) {
+    if (huart == NULL) {
+        return false;
+    }
+    if (huart->gState == HAL_UART_STATE_BUSY_TX) {
+        return huart->TxXferCount == 0U;
+    }
+    return (huart->Instance->CR1 & USART_CR1_TXEIE) != 0U;
+}
+
+bool host_uart_tx_irq(UART_HandleTypeDef *huart, uint8_t *byte) {
+    USART_TypeDef *usart = huart->Instance;
+
+    if (huart->gState == HAL_UART_STATE_BUSY_TX) {
+        // Transfer complete: the callback may chain the next one
+        huart->gState = HAL_UART_STATE_READY;
+        usart->SR |= HOST_SR_IDLE;
+        HAL_UART_TxCpltCallback(huart);
+        return false;
+    }
+
+    usart->DR = HOST_DR_EMPTY;
+    usart->SR |= USART_SR_TXE;
+    host_uart_irq(huart);
+    if (usart->DR == HOST_DR_EMPTY) {
+        return false;
+    }
+
+    *byte = (uint8_t) usart->DR;
+    usart->SR &= ~USART_SR_TC;
+    return true;
+}
+
+void host_uart_tx_poll(UART_HandleTypeDef *huart) {
+    if (huart == NULL) {
+        return;
+    }
+
+    for (;;) {
+        uint8_t byte;
+
+        if ((huart->gState == HAL_UART_STATE_BUSY_TX) && (huart->TxXferCount > 0U)) {
+            // The rest of the transfer in one piece
+            if (host_sink != NULL) {
+                host_sink(huart, &huart->pTxBuffPtr[huart->TxXferSize - huart->TxXferCount], huart->TxXferCount);
+            }
+            huart->TxXferCount = 0U;
+        } else if (!host_uart_tx_irq_pending(huart)) {
+            break;
+        } else if (host_uart_tx_irq(huart, &byte)) {
+            if (host_sink != NULL) {
+                host_sink(huart, &byte, 1U);
+            }
+        } else if (host_uart_tx_irq_pending(huart) && (huart->gState != HAL_UART_STATE_BUSY_TX)) {
+            break;  // TXE enabled with nothing to send yet, e.g. paused by XOFF
+        }
+    }
+
+    huart->Instance->SR |= HOST_SR_IDLE;
+}
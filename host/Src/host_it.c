@@ -0,0 +1,40 @@
+/**
+ * @file host_it.c
+ * @brief UART interrupt handler and HAL callbacks of the host build.
+ *
+ * Host counterpart of the USART1 handler and the HAL callbacks in
+ * Core/Src/stm32f4xx_it.c: the same dispatch to the driver registered for
+ * the instance, for whichever UART the stand-in raises them on.
+ *
+ * @author Santiago Rincon
+ * @date 2026
+ */
+
+#include "main.h"
+#include "uart_driver.h"
+
+void host_uart_irq(UART_HandleTypeDef *huart) {
+    uint32_t profile_start = uart_driver_profile_begin();
+    uart_driver_t *uart_driver = uart_driver_lookup(huart->Instance);
+
+    if (!uart_driver_irq_handler(uart_driver)) {
+        HAL_UART_IRQHandler(huart);
+    }
+    uart_driver_profile_end(uart_driver, profile_start);
+}
+
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart) {
+    uart_driver_rx_it_callback(uart_driver_lookup(huart->Instance));
+}
+
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size) {
+    uart_driver_rx_event_callback(uart_driver_lookup(huart->Instance), Size);
+}
+
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart) {
+    uart_driver_tx_it_callback(uart_driver_lookup(huart->Instance));
+}
+
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart) {
+    uart_driver_error_callback(uart_driver_lookup(huart->Instance));
+}
@@ -0,0 +1,280 @@
+/**
+ * @file host_main.c
+ * @brief The shell as a Linux program, over stdin/stdout or a pseudo-terminal.
+ *
+ * Runs the firmware's shell, CLI and UART driver unchanged on the HAL
+ * stand-in: what is read from the terminal arrives on USART1 and what the
+ * shell transmits is written back to it.
+ *
+ *   uart_shell_host              stdin/stdout, circular DMA like the target
+ *   uart_shell_host --it         interrupt-driven RX and TX
+ *   uart_shell_host --register   register-level interrupt handler
+ *   uart_shell_host --loopback   loopback transport, no UART driver at all
+ *   uart_shell_host --pty        on a new pseudo-terminal instead of stdio,
+ *                                e.g. to connect a terminal emulator to it
+ *   uart_shell_host --record f   also log the input to f, one line per read,
+ *                                for replay by bench_shell_latency
+ *
+ * End of input (Ctrl-D on a terminal) drains the output and exits.
+ *
+ * @author Santiago Rincon
+ * @date 2026
+ */
+
+#define _DEFAULT_SOURCE
+#define _XOPEN_SOURCE 700
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "main.h"
+#include "shell.h"
+#include "uart_driver.h"
+/* After the HAL: termios.h defines CR1..CR3 as macros, which are USART register names there */
+#include <termios.h>
+
+/** How long the main loop sleeps waiting for input */
+#define HOST_POLL_MS 10
+
+/** Bytes taken from the terminal at once; reception is paced so the RX ring never overflows */
+#define HOST_READ_CHUNK (UART_DRIVER_MAX_RX_BUFFER / 4U)
+
+/** Loopback output ring; its send cannot wait, so it holds the longest reply to one command */
+#define HOST_LOOPBACK_OUTPUT 4096U
+
+UART_HandleTypeDef huart1;
+DMA_HandleTypeDef hdma_usart1_rx;
+DMA_HandleTypeDef hdma_usart1_tx;
+
+shell_t shell = SHELL_INITIALIZER(shell, &huart1);
+
+static int host_in_fd = STDIN_FILENO;
+static int host_out_fd = STDOUT_FILENO;
+static struct termios host_saved_termios;
+static bool host_termios_saved;
+static FILE *host_record;
+static uint32_t host_record_tick;
+
+void Error_Handler(void) {
+    fprintf(stderr, "uart_shell_host: fatal error\n");
+    exit(EXIT_FAILURE);
+}
+
+static void host_write_all(const uint8_t *data, size_t length) {
+    while (length > 0U) {
+        ssize_t written = write(host_out_fd, data, length);
+        if (written <= 0) {
+            return;
+        }
+        data += written;
+        length -= (size_t) written;
+    }
+}
+
+static void host_uart_to_terminal(UART_HandleTypeDef *huart, const uint8_t *data, size_t length) {
+    (void) huart;
+    host_write_all(data, length);
+}
+
+/**
+ * @brief Logs an input chunk as "<ms since the previous chunk> <escaped bytes>".
+ */
+static void host_record_chunk(const uint8_t *data, size_t length) {
+    uint32_t now = HAL_GetTick();
+
+    fprintf(host_record, "%u ", (unsigned) (now - host_record_tick));
+    host_record_tick = now;
+    for (size_t i = 0U; i < length; i++) {
+        switch (data[i]) {
+        case '\\': fputs("\\\\", host_record); break;
+        case '\r': fputs("\\r", host_record); break;
+        case '\n': fputs("\\n", host_record); break;
+        case '\t': fputs("\\t", host_record); break;
+        case 0x1BU: fputs("\\e", host_record); break;
+        default:
+            if ((data[i] >= 0x20U) && (data[i] < 0x7FU)) {
+                fputc(data[i], host_record);
+            } else {
+                fprintf(host_record, "\\x%02X", data[i]);
+            }
+            break;
+        }
+    }
+    fputc('\n', host_record);
+    fflush(host_record);
+}
+
+/** Blocking shell output runs this while it waits, as the TX interrupts would free room */
+static void host_idle(void *context) {
+    host_uart_tx_poll((UART_HandleTypeDef *) context);
+}
+
+static void host_restore_terminal(void) {
+    if (host_termios_saved) {
+        tcsetattr(host_in_fd, TCSANOW, &host_saved_termios);
+    }
+}
+
+/**
+ * @brief Puts a terminal in raw mode, so the shell sees every key.
+ *
+ * Signals stay enabled so Ctrl-C still ends the program.
+ */
+static void host_raw_terminal(int fd, bool save) {
+    struct termios raw;
+
+    if (!isatty(fd) || (tcgetattr(fd, &raw) != 0)) {
+        return;
+    }
+    if (save) {
+        host_saved_termios = raw;
+        host_termios_saved = true;
+        atexit(host_restore_terminal);
+    }
+    cfmakeraw(&raw);
+    raw.c_lflag |= ISIG;
+    tcsetattr(fd, TCSANOW, &raw);
+}
+
+static int host_open_pty(void) {
+    int fd = posix_openpt(O_RDWR | O_NOCTTY);
+
+    if ((fd < 0) || (grantpt(fd) != 0) || (unlockpt(fd) != 0)) {
+        perror("uart_shell_host: pty");
+        exit(EXIT_FAILURE);
+    }
+
+    // Raw on the device side too, so CR is not turned into LF on the way in. The device stays
+    // open so the line does not hang up between the sessions of whatever connects to it.
+    int device = open(ptsname(fd), O_RDWR | O_NOCTTY);
+    if (device >= 0) {
+        host_raw_terminal(device, false);
+    }
+
+    fprintf(stderr, "uart_shell_host: listening on %s\n", ptsname(fd));
+    return fd;
+}
+
+static void host_usart1_init(bool dma) {
+    huart1.Instance = USART1;
+    huart1.Init.BaudRate = 115200;
+    huart1.Init.WordLength = UART_WORDLENGTH_8B;
+    huart1.Init.StopBits = UART_STOPBITS_1;
+    huart1.Init.Parity = UART_PARITY_NONE;
+    huart1.Init.Mode = UART_MODE_TX_RX;
+    huart1.Init.HwFlowCtl = UART_HWCONTROL_NONE;
+    huart1.Init.OverSampling = UART_OVERSAMPLING_16;
+    huart1.hdmarx = dma ? &hdma_usart1_rx : NULL;
+    huart1.hdmatx = dma ? &hdma_usart1_tx : NULL;
+    if (HAL_UART_Init(&huart1) != HAL_OK) {
+        Error_Handler();
+    }
+}
+
+static void host_usage(const char *program) {
+    fprintf(stderr, "usage: %s [--it | --register | --loopback] [--pty] [--record <file>]\n", program);
+}
+
+int main(int argc, char **argv) {
+    static uint8_t loopback_input[UART_DRIVER_MAX_RX_BUFFER];
+    static uint8_t loopback_output[HOST_LOOPBACK_OUTPUT];
+    static shell_loopback_t loopback;
+    bool dma = true;
+    bool use_loopback = false;
+    bool use_pty = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--it") == 0) {
+            dma = false;
+        } else if (strcmp(argv[i], "--register") == 0) {
+            shell.driver.backend = UART_DRIVER_BACKEND_REGISTER;
+        } else if (strcmp(argv[i], "--loopback") == 0) {
+            use_loopback = true;
+        } else if (strcmp(argv[i], "--pty") == 0) {
+            use_pty = true;
+        } else if ((strcmp(argv[i], "--record") == 0) && ((i + 1) < argc)) {
+            host_record = fopen(argv[++i], "w");
+            if (host_record == NULL) {
+                perror(argv[i]);
+                return EXIT_FAILURE;
+            }
+        } else {
+            host_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (use_pty) {
+        host_in_fd = host_open_pty();
+        host_out_fd = host_in_fd;
+    } else {
+        host_raw_terminal(host_in_fd, true);
+    }
+
+    if (use_loopback) {
+        shell_transport_t transport;
+        if (!shell_loopback_init(&loopback, loopback_input, sizeof(loopback_input),
+                                 loopback_output, sizeof(loopback_output)) ||
+            !shell_transport_bind_loopback(&transport, &loopback) ||
+            !shell_init_transport(&shell, &transport)) {
+            Error_Handler();
+        }
+    } else {
+        host_usart1_init(dma);
+        host_uart_set_sink(host_uart_to_terminal);
+        (void) uart_driver_set_idle_hook(shell_get_driver_instance(&shell), host_idle, &huart1);
+        if (!shell_start(&shell)) {
+            Error_Handler();
+        }
+    }
+
+    uint8_t buffer[HOST_READ_CHUNK];
+    bool input_open = true;
+
+    for (;;) {
+        if (use_loopback) {
+            size_t length;
+            while ((length = ring_buffer_read(&loopback.output, buffer, sizeof(buffer))) > 0U) {
+                host_write_all(buffer, length);
+            }
+        } else {
+            host_uart_tx_poll(&huart1);
+        }
+
+        // A new chunk only once the shell has taken the last one, as a paced sender would
+        if (shell_transport_ready(&shell.transport) > 0U) {
+            shell_task(&shell);
+            continue;
+        }
+        if (!input_open) {
+            break;
+        }
+
+        struct pollfd pfd = { .fd = host_in_fd, .events = POLLIN };
+        if (poll(&pfd, 1, HOST_POLL_MS) > 0) {
+            ssize_t length = read(host_in_fd, buffer, sizeof(buffer));
+            if (length <= 0) {
+                input_open = false;
+                continue;
+            }
+            if (host_record != NULL) {
+                host_record_chunk(buffer, (size_t) length);
+            }
+            if (use_loopback) {
+                (void) ring_buffer_write(&loopback.input, buffer, (size_t) length);
+            } else {
+                host_uart_rx(&huart1, buffer, (size_t) length);
+            }
+        }
+
+        shell_task(&shell);
+    }
+
+    (void) shell_flush(&shell, SHELL_TX_TIMEOUT_MS);
+    if (!use_loopback) {
+        host_uart_tx_poll(&huart1);
+    }
+    return EXIT_SUCCESS;
+}
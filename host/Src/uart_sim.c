@@ -0,0 +1,269 @@
+/**
+ * @file uart_sim.c
+ * @brief Virtual-time simulation of a UART line under the HAL stand-in.
+ *
+ * A discrete event loop: the earliest of the next received byte, the end
+ * of the byte being shifted out, the transmitter interrupt, the idle line
+ * event and the main loop task runs next, and the clock jumps to it.
+ *
+ * @author Santiago Rincon
+ * @date 2026
+ */
+
+#include <string.h>
+#include "uart_sim.h"
+
+typedef enum {
+    UART_SIM_EVENT_NONE = 0,
+    UART_SIM_EVENT_RX,          /**< Peer byte handed to the driver */
+    UART_SIM_EVENT_TX_END,      /**< Byte finished leaving the line */
+    UART_SIM_EVENT_TX_IRQ,      /**< Transmitter interrupt */
+    UART_SIM_EVENT_RX_IDLE,     /**< Idle line after reception */
+    UART_SIM_EVENT_TASK         /**< Main loop task */
+} uart_sim_event_t;
+
+static uint64_t uart_sim_clock(void *context) {
+    return ((const uart_sim_t *) context)->now_ns;
+}
+
+/**
+ * @brief Line time of one character, following baud rate changes made through the HAL.
+ */
+static uint64_t uart_sim_frame_ns(const uart_sim_t *sim) {
+    uint32_t baud_rate = (sim->config.baud_rate != 0U) ? sim->config.baud_rate : sim->huart->Init.BaudRate;
+
+    return (((uint64_t) sim->config.frame_bits * 1000000000ULL) + (baud_rate / 2U)) / baud_rate;
+}
+
+static void uart_sim_tx_start(uart_sim_t *sim, uint8_t byte) {
+    sim->tx_shift = byte;
+    sim->tx_shift_end_ns = sim->now_ns + uart_sim_frame_ns(sim);
+    sim->tx_shifting = true;
+}
+
+/**
+ * @brief Moves the transmitter on after anything that may have changed its state.
+ *
+ * Starts the next byte when the shift register is free, and raises the
+ * interrupt the transmitter waits for: TXE as soon as DR is free (it is
+ * double buffered), TX complete only once the last byte has left the line.
+ */
+static void uart_sim_tx_advance(uart_sim_t *sim) {
+    UART_HandleTypeDef *huart = sim->huart;
+    uint8_t byte;
+
+    if (!sim->tx_shifting) {
+        if (sim->tx_holding) {
+            sim->tx_holding = false;
+            uart_sim_tx_start(sim, sim->tx_hold);
+        } else if (host_uart_tx_fetch(huart, &byte)) {
+            uart_sim_tx_start(sim, byte);
+        }
+    }
+
+    if (!sim->tx_irq_scheduled && !sim->tx_holding && !sim->tx_stalled && host_uart_tx_irq_pending(huart) &&
+        ((huart->gState != HAL_UART_STATE_BUSY_TX) || !sim->tx_shifting)) {
+        sim->tx_irq_ns = sim->now_ns + sim->config.isr_latency_ns;
+        sim->tx_irq_scheduled = true;
+    }
+
+    if (!sim->tx_shifting && !sim->tx_holding && !sim->tx_irq_scheduled) {
+        huart->Instance->SR |= USART_SR_TC;
+    }
+}
+
+/**
+ * @brief Finds the earliest pending event; on a tie the one listed first wins.
+ */
+static uart_sim_event_t uart_sim_next_event(const uart_sim_t *sim, uint64_t *time_ns) {
+    uart_sim_event_t event = UART_SIM_EVENT_NONE;
+    uint64_t time = UINT64_MAX;
+
+    if (sim->rx_next_valid && ((sim->rx_next.end_ns + sim->config.isr_latency_ns) < time)) {
+        time = sim->rx_next.end_ns + sim->config.isr_latency_ns;
+        event = UART_SIM_EVENT_RX;
+    }
+    if (sim->tx_shifting && (sim->tx_shift_end_ns < time)) {
+        time = sim->tx_shift_end_ns;
+        event = UART_SIM_EVENT_TX_END;
+    }
+    if (sim->tx_irq_scheduled && (sim->tx_irq_ns < time)) {
+        time = sim->tx_irq_ns;
+        event = UART_SIM_EVENT_TX_IRQ;
+    }
+    if (sim->rx_idle_scheduled && (sim->rx_idle_ns < time)) {
+        time = sim->rx_idle_ns;
+        event = UART_SIM_EVENT_RX_IDLE;
+    }
+    if ((sim->task != NULL) && !sim->in_task && (sim->task_ns < time)) {
+        time = sim->task_ns;
+        event = UART_SIM_EVENT_TASK;
+    }
+
+    *time_ns = time;
+    return event;
+}
+
+static void uart_sim_run_event(uart_sim_t *sim, uart_sim_event_t event, uint64_t time_ns) {
+    UART_HandleTypeDef *huart = sim->huart;
+    uint8_t byte;
+
+    if (time_ns > sim->now_ns) {
+        sim->now_ns = time_ns;
+    }
+
+    switch (event) {
+    case UART_SIM_EVENT_RX: {
+        uart_sim_rx_t rx = sim->rx_next;
+        sim->rx_next_valid = element_ring_pop(&sim->rx_queue, &sim->rx_next);
+        host_uart_rx_byte(huart, rx.byte);
+        sim->rx_bytes++;
+        // The idle flag rises once a whole frame passes without a start bit
+        sim->rx_idle_ns = rx.end_ns + uart_sim_frame_ns(sim) + sim->config.isr_latency_ns;
+        sim->rx_idle_scheduled = true;
+        break;
+    }
+
+    case UART_SIM_EVENT_TX_END:
+        sim->tx_shifting = false;
+        sim->tx_bytes++;
+        if (sim->peer_rx != NULL) {
+            sim->peer_rx(sim->peer_context, sim->tx_shift, sim->now_ns);
+        }
+        break;
+
+    case UART_SIM_EVENT_TX_IRQ:
+        sim->tx_irq_scheduled = false;
+        if (host_uart_tx_irq(huart, &byte)) {
+            sim->tx_hold = byte;
+            sim->tx_holding = true;
+        } else if ((huart->gState != HAL_UART_STATE_BUSY_TX) && host_uart_tx_irq_pending(huart)) {
+            sim->tx_stalled = true;     // TXE left enabled with nothing to send, e.g. paused by XOFF
+        }
+        break;
+
+    case UART_SIM_EVENT_RX_IDLE:
+        sim->rx_idle_scheduled = false;
+        host_uart_rx_idle(huart);
+        break;
+
+    case UART_SIM_EVENT_TASK:
+        sim->in_task = true;
+        sim->task(sim->task_context);
+        sim->in_task = false;
+        sim->task_ns = sim->now_ns + sim->config.poll_period_ns;
+        sim->tx_stalled = false;
+        break;
+
+    default:
+        break;
+    }
+
+    uart_sim_tx_advance(sim);
+}
+
+bool uart_sim_init(uart_sim_t *sim, UART_HandleTypeDef *huart, const uart_sim_config_t *config) {
+    static const uart_sim_config_t defaults = UART_SIM_CONFIG_DEFAULT;
+
+    if ((sim == NULL) || (huart == NULL) || (huart->Instance == NULL)) {
+        return false;
+    }
+
+    memset(sim, 0, sizeof(uart_sim_t));
+    sim->huart = huart;
+    sim->config = (config != NULL) ? *config : defaults;
+    if ((sim->config.frame_bits == 0U) || (sim->config.poll_period_ns == 0U) ||
+        ((sim->config.baud_rate == 0U) && (huart->Init.BaudRate == 0U)) ||
+        !element_ring_init(&sim->rx_queue, sim->rx_storage, sizeof(uart_sim_rx_t), UART_SIM_PEER_QUEUE)) {
+        return false;
+    }
+
+    host_set_clock(uart_sim_clock, sim);
+    return true;
+}
+
+void uart_sim_deinit(uart_sim_t *sim) {
+    (void) sim;
+    host_set_clock(NULL, NULL);
+}
+
+void uart_sim_set_task(uart_sim_t *sim, uart_sim_task_t task, void *context) {
+    sim->task_context = context;
+    sim->task = task;
+    sim->task_ns = sim->now_ns;
+}
+
+void uart_sim_set_peer_rx(uart_sim_t *sim, uart_sim_peer_rx_t peer_rx, void *context) {
+    sim->peer_context = context;
+    sim->peer_rx = peer_rx;
+}
+
+size_t uart_sim_peer_send(uart_sim_t *sim, const uint8_t *data, size_t length) {
+    size_t queued;
+
+    if ((sim == NULL) || (data == NULL)) {
+        return 0U;
+    }
+
+    for (queued = 0U; queued < length; queued++) {
+        uint64_t start = (sim->rx_line_free_ns > sim->now_ns) ? sim->rx_line_free_ns : sim->now_ns;
+        uart_sim_rx_t rx = { .end_ns = start + uart_sim_frame_ns(sim), .byte = data[queued] };
+
+        if (!sim->rx_next_valid) {
+            sim->rx_next = rx;
+            sim->rx_next_valid = true;
+        } else if (!element_ring_push(&sim->rx_queue, &rx)) {
+            break;
+        }
+        sim->rx_line_free_ns = rx.end_ns;
+    }
+
+    return queued;
+}
+
+uint64_t uart_sim_peer_done_ns(const uart_sim_t *sim) {
+    return (sim->rx_line_free_ns > sim->now_ns) ? sim->rx_line_free_ns : sim->now_ns;
+}
+
+void uart_sim_run_until(uart_sim_t *sim, uint64_t until_ns) {
+    for (;;) {
+        uint64_t time_ns;
+
+        uart_sim_tx_advance(sim);
+        uart_sim_event_t event = uart_sim_next_event(sim, &time_ns);
+        if ((event == UART_SIM_EVENT_NONE) || (time_ns > until_ns)) {
+            break;
+        }
+        uart_sim_run_event(sim, event, time_ns);
+    }
+
+    if (sim->now_ns < until_ns) {
+        sim->now_ns = until_ns;
+    }
+}
+
+bool uart_sim_busy(uart_sim_t *sim) {
+    uart_sim_tx_advance(sim);
+
+    return sim->tx_shifting || sim->tx_holding || sim->tx_irq_scheduled || sim->rx_next_valid ||
+           sim->rx_idle_scheduled || (sim->huart->gState == HAL_UART_STATE_BUSY_TX);
+}
+
+void uart_sim_idle_hook(void *context) {
+    uart_sim_t *sim = (uart_sim_t *) context;
+    uint64_t time_ns;
+
+    // The waiting call may just have handed the transmitter its first byte
+    uart_sim_tx_advance(sim);
+
+    // Never the task itself, and no further than a poll period so timeouts expire on time
+    bool in_task = sim->in_task;
+    sim->in_task = true;
+    uart_sim_event_t event = uart_sim_next_event(sim, &time_ns);
+    if ((event == UART_SIM_EVENT_NONE) || (time_ns > (sim->now_ns + sim->config.poll_period_ns))) {
+        sim->now_ns += sim->config.poll_period_ns;
+    } else {
+        uart_sim_run_event(sim, event, time_ns);
+    }
+    sim->in_task = in_task;
+}